@@ -18,3 +18,49 @@ inline void panningEqualPower(float panning, float& left, float& right)
     left = std::cos(x);
     right = std::sin(x);
 }
+
+// First-order highpass at a few hertz for both channels. In the feedback
+// loop it keeps an offset from adding up with every repeat. The gain is
+// scaled to exactly one at Nyquist, so the loop gain never rises above the
+// feedback amount at any frequency.
+class DCBlocker
+{
+public:
+    void prepare(double sampleRate) noexcept
+    {
+        pole = float(std::exp(-2.0 * 3.141592653589793 * cutoff / sampleRate));
+        gain = (1.0f + pole) * 0.5f;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        inputL = inputR = outputL = outputR = 0.0f;
+    }
+
+    void processSample(float& left, float& right) noexcept
+    {
+        outputL = gain * (left - inputL) + pole * outputL;
+        outputR = gain * (right - inputR) + pole * outputR;
+        inputL = left;
+        inputR = right;
+        left = outputL;
+        right = outputR;
+    }
+
+    void process(float* left, float* right, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            processSample(left[i], right[i]);
+        }
+    }
+
+private:
+    static constexpr double cutoff = 5.0;
+
+    float pole = 0.0f;
+    float gain = 1.0f;
+    float inputL = 0.0f, inputR = 0.0f;
+    float outputL = 0.0f, outputR = 0.0f;
+};
@@ -0,0 +1,468 @@
+/*
+  ==============================================================================
+
+    DelayBuffer.cpp
+    Created: 19 Oct 2026 2:58:30pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "DelayBuffer.h"
+#include "Trace.h"
+
+DelayBuffer::GrowThread::GrowThread()
+    : juce::TimeSliceThread("Delay history")
+{
+    startThread(juce::Thread::Priority::background);
+}
+
+DelayBuffer::GrowThread::~GrowThread()
+{
+    stopThread(5000);
+}
+
+DelayBuffer::DelayBuffer()
+{
+    growThread->addTimeSliceClient(this);
+}
+
+DelayBuffer::~DelayBuffer()
+{
+    // Waits for a slab being taken from the pool.
+    growThread->removeTimeSliceClient(this);
+
+    delete grown.exchange(nullptr);
+    delete retired.exchange(nullptr);
+}
+
+int DelayBuffer::getSizeForDelay(int maxDelayInSamples) noexcept
+{
+    // One slot for the sample being written and one for the older
+    // neighbour of the longest delay.
+    return maxDelayInSamples + 2;
+}
+
+size_t DelayBuffer::getChannelLength(int slabSize, Storage slabStorage) noexcept
+{
+    // Full floats start each channel on a 64-byte boundary.
+    if (slabStorage == Storage::compact)
+    {
+        return size_t(slabSize + 1);
+    }
+    return size_t(slabSize + 1 + 15) / 16 * 16;
+}
+
+size_t DelayBuffer::getSlabBytes(int slabSize) const noexcept
+{
+    size_t sampleSize = storage == Storage::compact ? sizeof(juce::uint16) : sizeof(float);
+    return 2 * getChannelLength(slabSize, storage) * sampleSize;
+}
+
+char* DelayBuffer::getRawPointer(const MemoryPool::Slab& slab, int slabSize, int channel, int slot) const noexcept
+{
+    size_t sampleSize = storage == Storage::compact ? sizeof(juce::uint16) : sizeof(float);
+    size_t index = size_t(channel) * getChannelLength(slabSize, storage) + size_t(slot + 1);
+    return slab.getData<char>() + index * sampleSize;
+}
+
+void DelayBuffer::referToMemory() noexcept
+{
+    buffer.setSize(0, 0);
+    compact = nullptr;
+    if (storage == Storage::compact)
+    {
+        compact = memory.getData<juce::uint16>();
+    }
+    else if (float* data = memory.getData<float>())
+    {
+        float* channels[] = { data, data + getChannelLength(size, storage) };
+        buffer.setDataToReferTo(channels, 2, size + 1);
+    }
+}
+
+bool DelayBuffer::prepare(int maxDelayInSamples, const VectorKernels& newKernels, Storage newStorage)
+{
+    // The audio thread is stopped, but the background thread may be taking
+    // a slab for the old size.
+    const juce::ScopedLock sl(growLock);
+    delete grown.exchange(nullptr);
+    delete retired.exchange(nullptr);
+    requestedSize.store(0);
+    largestGrown = 0;
+    growth.reset();
+
+    int newSize = getSizeForDelay(maxDelayInSamples);
+    bool allocated = memory.getData<void>() != nullptr;
+
+    if (newSize != size || newStorage != storage || !allocated)
+    {
+        size = newSize;
+        storage = newStorage;
+
+        // Only the format in use holds memory. The old slab goes back
+        // first, so the pool can hand it to the next instance that asks for
+        // the same size. New memory comes cleared, and a half float of zero
+        // is all zero bits.
+        memory.reset();
+        memory = pool->allocate(getSlabBytes(size));
+        referToMemory();
+    }
+
+    kernels = &newKernels;
+    numWritten = 0;
+    writeIndex = 0;
+    reset();
+    return memory.getData<void>() != nullptr;
+}
+
+void DelayBuffer::reserve(int maxDelayInSamples)
+{
+    int newSize = getSizeForDelay(maxDelayInSamples);
+    if (newSize <= size || memory.getData<void>() == nullptr)
+    {
+        return;
+    }
+
+    // Whatever the background thread had started on is dropped, and the
+    // old slab can go straight back.
+    delete retired.exchange(nullptr);
+    growth = std::make_unique<Growth>();
+    growth->memory = pool->allocate(getSlabBytes(newSize));
+    growth->size = newSize;
+    if (growth->memory.getData<void>() == nullptr)
+    {
+        growth.reset();
+        return;
+    }
+    numCopied = std::max<juce::int64>(0, numWritten - std::min(numValid + 1, size));
+    copyIntoGrowth(numWritten - numCopied);
+    delete retired.exchange(nullptr);
+}
+
+void DelayBuffer::grow(int maxDelayInSamples, int numSamples) noexcept
+{
+    if (memory.getData<void>() == nullptr)
+    {
+        return;
+    }
+
+    int newSize = getSizeForDelay(maxDelayInSamples);
+    if (growth == nullptr)
+    {
+        if (newSize > size && newSize > requestedSize.load(std::memory_order_relaxed))
+        {
+            requestedSize.store(newSize, std::memory_order_relaxed);
+        }
+
+        // The slot for the old slab has to be free before a switch.
+        if (retired.load(std::memory_order_acquire) != nullptr)
+        {
+            return;
+        }
+
+        growth.reset(grown.exchange(nullptr, std::memory_order_acquire));
+        if (growth == nullptr)
+        {
+            return;
+        }
+        if (growth->size <= size)
+        {
+            // reserve got there first.
+            retired.store(growth.release(), std::memory_order_release);
+            return;
+        }
+
+        // Everything a read may still reach, which is the valid samples and
+        // the older neighbour of the oldest one.
+        numCopied = std::max<juce::int64>(0, numWritten - std::min(numValid + 1, size));
+    }
+
+    DELAY_TRACE_ZONE("history growth");
+    copyIntoGrowth(std::max(2 * numSamples, minCopySlice));
+}
+
+void DelayBuffer::copyIntoGrowth(juce::int64 maxSamples) noexcept
+{
+    juce::int64 end = std::min(numWritten, numCopied + maxSamples);
+    while (numCopied < end)
+    {
+        // A sample keeps its number, so it sits at that number modulo the
+        // size in either slab.
+        int from = int(numCopied % size);
+        int to = int(numCopied % growth->size);
+        int length = int(std::min({ end - numCopied, juce::int64(size - from), juce::int64(growth->size - to) }));
+        size_t numBytes = size_t(length) * (storage == Storage::compact ? sizeof(juce::uint16) : sizeof(float));
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            std::memcpy(getRawPointer(growth->memory, growth->size, channel, to),
+                        getRawPointer(memory, size, channel, from), numBytes);
+        }
+        numCopied += length;
+    }
+
+    if (numCopied == numWritten)
+    {
+        switchToGrowth();
+    }
+}
+
+void DelayBuffer::switchToGrowth() noexcept
+{
+    std::swap(memory, growth->memory);
+    std::swap(size, growth->size);
+    referToMemory();
+    writeIndex = int(numWritten % size);
+
+    // Slot 0 mirrors the last slot, which was copied without it.
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        std::memcpy(getRawPointer(memory, size, channel, -1), getRawPointer(memory, size, channel, size - 1),
+                    storage == Storage::compact ? sizeof(juce::uint16) : sizeof(float));
+    }
+
+    // The background thread frees the old slab before it takes the next
+    // one, so the slot is always empty here.
+    jassert(retired.load() == nullptr);
+    retired.store(growth.release(), std::memory_order_release);
+}
+
+int DelayBuffer::useTimeSlice()
+{
+    const juce::ScopedLock sl(growLock);
+    delete retired.exchange(nullptr, std::memory_order_acquire);
+
+    int newSize = requestedSize.load();
+    if (newSize > largestGrown && grown.load() == nullptr)
+    {
+        // A pool out of memory is not asked again for the same size.
+        largestGrown = newSize;
+        auto next = std::make_unique<Growth>();
+        next->memory = pool->allocate(getSlabBytes(newSize));
+        next->size = newSize;
+        if (next->memory.getData<void>() != nullptr)
+        {
+            grown.store(next.release(), std::memory_order_release);
+        }
+    }
+
+    // Growing is rare, but the longer delay waits for it.
+    return 50;
+}
+
+void DelayBuffer::reset() noexcept
+{
+    if (memory.getData<void>() == nullptr)
+    {
+        numValid = 0;
+        return;
+    }
+
+    // The first sample written after the reset interpolates towards the
+    // newest slot before it, which is therefore the only one cleared.
+    int newest = writeIndex == 0 ? size - 1 : writeIndex - 1;
+    writeSlot(0, newest, 0.0f);
+    writeSlot(1, newest, 0.0f);
+    numValid = 0;
+
+    // A growth that already has the newest sample copies the cleared one.
+    if (growth != nullptr)
+    {
+        numCopied = std::min(numCopied, std::max<juce::int64>(0, numWritten - 1));
+    }
+}
+
+size_t DelayBuffer::getNumBytes() const noexcept
+{
+    if (memory.getData<void>() == nullptr)
+    {
+        return 0;
+    }
+    size_t sampleSize = storage == Storage::compact ? sizeof(juce::uint16) : sizeof(float);
+    return size_t(2 * (size + 1)) * sampleSize;
+}
+
+void DelayBuffer::writeSlot(int channel, int slot, float value) noexcept
+{
+    if (storage == Storage::compact)
+    {
+        juce::uint16 half = HalfFloat::fromFloat(value);
+        *getCompactPointer(channel, slot + 1) = half;
+        if (slot == size - 1)
+        {
+            *getCompactPointer(channel, 0) = half;
+        }
+        return;
+    }
+
+    buffer.setSample(channel, slot + 1, value);
+    if (slot == size - 1)
+    {
+        buffer.setSample(channel, 0, value);
+    }
+}
+
+void DelayBuffer::pushSample(float left, float right) noexcept
+{
+    writeSlot(0, writeIndex, left);
+    writeSlot(1, writeIndex, right);
+    if (++writeIndex == size)
+    {
+        writeIndex = 0;
+    }
+    ++numWritten;
+    numValid = std::min(size, numValid + 1);
+}
+
+void DelayBuffer::popSample(float delayInSamples, float& left, float& right) const noexcept
+{
+    int delayInt = static_cast<int>(delayInSamples);
+    float fraction = delayInSamples - float(delayInt);
+
+    // Written before the last reset.
+    if (delayInt >= numValid)
+    {
+        left = 0.0f;
+        right = 0.0f;
+        return;
+    }
+
+    // The newest sample sits just before the write position. The delay is
+    // never longer than the buffer, so one wrap is enough.
+    jassert(delayInt <= size - 2);
+    int slot = writeIndex - 1 - delayInt;
+    if (slot < 0)
+    {
+        slot += size;
+    }
+
+    // Same formula as the scalar kernels, so both paths agree exactly.
+    if (storage == Storage::compact)
+    {
+        const juce::uint16* dataL = getCompactPointer(0, slot);
+        const juce::uint16* dataR = getCompactPointer(1, slot);
+        float newerL = HalfFloat::toFloat(dataL[1]);
+        float newerR = HalfFloat::toFloat(dataR[1]);
+        left = newerL + fraction * (HalfFloat::toFloat(dataL[0]) - newerL);
+        right = newerR + fraction * (HalfFloat::toFloat(dataR[0]) - newerR);
+        return;
+    }
+
+    const float* dataL = buffer.getReadPointer(0, slot);
+    const float* dataR = buffer.getReadPointer(1, slot);
+    left = dataL[1] + fraction * (dataL[0] - dataL[1]);
+    right = dataR[1] + fraction * (dataR[0] - dataR[1]);
+}
+
+void DelayBuffer::read(float* left, float* right, float delayInSamples, int numSamples) const noexcept
+{
+    int delayInt = static_cast<int>(delayInSamples);
+    float fraction = delayInSamples - float(delayInt);
+    jassert(numSamples <= delayInt);
+
+    // The start of the block may still reach back to before the last reset.
+    int numStale = juce::jlimit(0, numSamples, delayInt - numValid);
+    juce::FloatVectorOperations::clear(left, numStale);
+    juce::FloatVectorOperations::clear(right, numStale);
+
+    int slot = (writeIndex - delayInt + numStale + size) % size;
+    int done = numStale;
+
+    // At most two contiguous runs, split where the ring wraps around.
+    while (done < numSamples)
+    {
+        int length = std::min(numSamples - done, size - slot);
+
+        if (storage == Storage::compact)
+        {
+            const juce::uint16* newerL = getCompactPointer(0, slot + 1);
+            const juce::uint16* newerR = getCompactPointer(1, slot + 1);
+            kernels->interpolateHalf(left + done, newerL, newerL - 1, fraction, length);
+            kernels->interpolateHalf(right + done, newerR, newerR - 1, fraction, length);
+        }
+        else
+        {
+            const float* newerL = buffer.getReadPointer(0, slot + 1);
+            const float* newerR = buffer.getReadPointer(1, slot + 1);
+            kernels->interpolate(left + done, newerL, newerL - 1, fraction, length);
+            kernels->interpolate(right + done, newerR, newerR - 1, fraction, length);
+        }
+
+        done += length;
+        slot = 0;
+    }
+}
+
+void DelayBuffer::copyHistory(float* left, float* right, int age, int numSamples) const noexcept
+{
+    jassert(age >= numSamples && age < size);
+    int numStale = juce::jlimit(0, numSamples, age - numValid);
+    juce::FloatVectorOperations::clear(left, numStale);
+    juce::FloatVectorOperations::clear(right, numStale);
+
+    int slot = writeIndex - age + numStale;
+    if (slot < 0)
+    {
+        slot += size;
+    }
+    
+    int done = numStale;
+    while (done < numSamples)
+    {
+        int length = std::min(numSamples - done, size - slot);
+        
+        // A fraction of zero returns the newer sample, decoded.
+        if (storage == Storage::compact)
+        {
+            kernels->interpolateHalf(left + done, getCompactPointer(0, slot + 1), getCompactPointer(0, slot), 0.0f, length);
+            kernels->interpolateHalf(right + done, getCompactPointer(1, slot + 1), getCompactPointer(1, slot), 0.0f, length);
+        }
+        else
+        {
+            juce::FloatVectorOperations::copy(left + done, buffer.getReadPointer(0, slot + 1), length);
+            juce::FloatVectorOperations::copy(right + done, buffer.getReadPointer(1, slot + 1), length);
+        }
+        
+        done += length;
+        slot = 0;
+    }
+}
+
+void DelayBuffer::write(const float* left, const float* right, int numSamples) noexcept
+{
+    numWritten += numSamples;
+    numValid = std::min(size, numValid + numSamples);
+    int done = 0;
+    while (done < numSamples)
+    {
+        int length = std::min(numSamples - done, size - writeIndex);
+
+        if (storage == Storage::compact)
+        {
+            kernels->encodeHalf(getCompactPointer(0, writeIndex + 1), left + done, length);
+            kernels->encodeHalf(getCompactPointer(1, writeIndex + 1), right + done, length);
+        }
+        else
+        {
+            juce::FloatVectorOperations::copy(buffer.getWritePointer(0, writeIndex + 1), left + done, length);
+            juce::FloatVectorOperations::copy(buffer.getWritePointer(1, writeIndex + 1), right + done, length);
+        }
+
+        writeIndex += length;
+        if (writeIndex == size)
+        {
+            if (storage == Storage::compact)
+            {
+                *getCompactPointer(0, 0) = *getCompactPointer(0, size);
+                *getCompactPointer(1, 0) = *getCompactPointer(1, size);
+            }
+            else
+            {
+                buffer.setSample(0, 0, buffer.getSample(0, size));
+                buffer.setSample(1, 0, buffer.getSample(1, size));
+            }
+            writeIndex = 0;
+        }
+        done += length;
+    }
+}
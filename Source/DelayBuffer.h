@@ -0,0 +1,191 @@
+/*
+  ==============================================================================
+
+    DelayBuffer.h
+    Created: 19 Oct 2026 2:58:30pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "VectorKernels.h"
+#include "MemoryPool.h"
+
+// Stereo ring buffer with linear interpolation, like the JUCE DelayLine, but
+// it can also be read and written a block at a time through VectorKernels.
+//
+// Slot 0 of each channel mirrors the last slot, so the older neighbour of
+// every sample sits directly in front of it and a block read never has to
+// wrap in the middle of an interpolation.
+//
+// Resetting takes constant time. The history keeps whatever it held and
+// everything written before the reset reads as silence until it has been
+// overwritten, so no stale sample is ever heard and nothing is cleared.
+//
+// Compact storage keeps the history as half floats. That halves the memory
+// of long delays, at the cost of an 11-bit mantissa: the rounding error
+// follows the signal level at about -66 dB instead of sitting at a fixed
+// floor, and there is no clipping.
+//
+// The history is a slab from the process-wide MemoryPool, with every page
+// touched before playback starts.
+//
+// It can grow while playing. A background thread shared by all instances
+// takes the larger slab from the pool, and the audio thread copies the
+// history into it a slice per block, oldest samples first and at least
+// twice as fast as the history moves on, so the copy never falls behind.
+// Reads keep using the old slab until the copy is complete, and the old
+// slab goes back to the background thread to be released.
+class DelayBuffer : private juce::TimeSliceClient
+{
+public:
+    DelayBuffer();
+    ~DelayBuffer() override;
+
+    enum class Storage
+    {
+        full,
+        compact,
+    };
+
+    // Preparing again with the same size and storage keeps the memory and
+    // only resets it. Returns false if the pool had no memory for the
+    // history, which must then not be read or written until a prepare
+    // succeeds.
+    bool prepare(int maxDelayInSamples, const VectorKernels& kernels, Storage storage = Storage::full);
+    void reset() noexcept;
+
+    // Not for the audio thread. Grows the history for delays of up to
+    // maxDelayInSamples right away, for offline renders, which must not
+    // depend on the timing of the background thread.
+    void reserve(int maxDelayInSamples);
+
+    // Audio thread, once per block before the block is written. A history
+    // shorter than maxDelayInSamples asks the background thread for more
+    // memory, and one that has it moves a slice closer to using it. Until
+    // then getMaxDelay stays where it was. If the pool has nothing to give,
+    // the history simply keeps its size.
+    void grow(int maxDelayInSamples, int numSamples) noexcept;
+
+    Storage getStorage() const noexcept
+    {
+        return storage;
+    }
+
+    size_t getNumBytes() const noexcept;
+
+    void setKernels(const VectorKernels& newKernels) noexcept
+    {
+        kernels = &newKernels;
+    }
+
+    // Per-sample access: writes one sample, then reads the sample that was
+    // written delayInSamples ago. A delay of zero returns the input.
+    void pushSample(float left, float right) noexcept;
+    void popSample(float delayInSamples, float& left, float& right) const noexcept;
+
+    // Block access: reads the delayed signal for the next numSamples samples
+    // before they are written. numSamples must not be larger than the whole
+    // part of the delay, otherwise the read would need samples from the
+    // block itself.
+    void read(float* left, float* right, float delayInSamples, int numSamples) const noexcept;
+    void write(const float* left, const float* right, int numSamples) noexcept;
+    
+    // Copies numSamples samples without interpolation, oldest first,
+    // starting with the one written age samples ago. Age 1 is the newest.
+    void copyHistory(float* left, float* right, int age, int numSamples) const noexcept;
+    
+    // Samples written since prepare. Unlike the write position it never
+    // wraps, so it can tell how far the history has moved on.
+    juce::int64 getNumWritten() const noexcept
+    {
+        return numWritten;
+    }
+    
+    int getSize() const noexcept
+    {
+        return size;
+    }
+
+    // The longest delay the history holds right now.
+    int getMaxDelay() const noexcept
+    {
+        return size - 2;
+    }
+
+private:
+    void writeSlot(int channel, int slot, float value) noexcept;
+
+    static int getSizeForDelay(int maxDelayInSamples) noexcept;
+    static size_t getChannelLength(int size, Storage storage) noexcept;
+    size_t getSlabBytes(int newSize) const noexcept;
+    void referToMemory() noexcept;
+
+    // Raw access to a slab laid out like the history, for copying between
+    // two of them whatever the storage.
+    char* getRawPointer(const MemoryPool::Slab& slab, int slabSize, int channel, int slot) const noexcept;
+
+    // A larger slab on its way from the background thread, or the old one
+    // on its way back.
+    struct Growth
+    {
+        MemoryPool::Slab memory;
+        int size = 0;
+    };
+
+    // Copies up to maxSamples samples into the growth, oldest first, and
+    // switches over to it once it has everything.
+    void copyIntoGrowth(juce::int64 maxSamples) noexcept;
+    void switchToGrowth() noexcept;
+
+    class GrowThread : public juce::TimeSliceThread
+    {
+    public:
+        GrowThread();
+        ~GrowThread() override;
+    };
+
+    int useTimeSlice() override;
+
+    // The copy never takes less than this per block, so a long history is
+    // moved over in a few dozen blocks even when they are small.
+    static constexpr int minCopySlice = 32768;
+
+    juce::uint16* getCompactPointer(int channel, int slot) const noexcept
+    {
+        return compact + channel * (size + 1) + slot;
+    }
+
+    // Declared before the slab, which has to go back to it first.
+    juce::SharedResourcePointer<MemoryPool> pool;
+    MemoryPool::Slab memory;
+
+    // The full history refers to the slab, one channel after the other,
+    // each starting on a 64-byte boundary.
+    juce::AudioBuffer<float> buffer;
+    juce::uint16* compact = nullptr;
+    Storage storage = Storage::full;
+    const VectorKernels* kernels = nullptr;
+    int size = 0;
+    int writeIndex = 0;
+    juce::int64 numWritten = 0;
+    
+    // Samples written since the last reset, up to the size. A sample is
+    // only read if its age is not larger than this.
+    int numValid = 0;
+
+    // The growth being copied into, and the number of the next sample to
+    // copy, counted like numWritten.
+    std::unique_ptr<Growth> growth;
+    juce::int64 numCopied = 0;
+
+    juce::CriticalSection growLock;
+    std::atomic<Growth*> grown { nullptr };
+    std::atomic<Growth*> retired { nullptr };
+    std::atomic<int> requestedSize { 0 };
+    int largestGrown = 0;
+    juce::SharedResourcePointer<GrowThread> growThread;
+};
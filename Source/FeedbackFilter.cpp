@@ -0,0 +1,121 @@
+/*
+  ==============================================================================
+
+    FeedbackFilter.cpp
+    Created: 19 Oct 2026 3:37:12pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "FeedbackFilter.h"
+
+// Resonances of the second order sections of Butterworth filters of
+// order 2, 4 and 8.
+static constexpr float resonances12[] = { 0.70710678f };
+static constexpr float resonances24[] = { 0.54119610f, 1.30656296f };
+static constexpr float resonances48[] = { 0.50979558f, 0.60134489f, 0.89997622f, 2.56291545f };
+
+static const float* getResonances(FeedbackFilter::Slope slope) noexcept
+{
+    switch (slope)
+    {
+        case FeedbackFilter::Slope::db24: return resonances24;
+        case FeedbackFilter::Slope::db48: return resonances48;
+        case FeedbackFilter::Slope::db12: break;
+    }
+    return resonances12;
+}
+
+void FeedbackFilter::prepare(double newSampleRate, const VectorKernels& newKernels) noexcept
+{
+    sampleRate = newSampleRate;
+    kernels = &newKernels;
+    updateCoefficients();
+    reset();
+}
+
+void FeedbackFilter::reset() noexcept
+{
+    std::fill(std::begin(lanes.s1), std::end(lanes.s1), 0.0f);
+    std::fill(std::begin(lanes.s2), std::end(lanes.s2), 0.0f);
+    std::fill(std::begin(lanes.pipe), std::end(lanes.pipe), 0.0f);
+}
+
+void FeedbackFilter::setSlope(Slope newSlope) noexcept
+{
+    if (newSlope != slope)
+    {
+        slope = newSlope;
+        updateCoefficients();
+        reset();
+    }
+}
+
+void FeedbackFilter::setCutoffs(float newLowCut, float newHighCut) noexcept
+{
+    if (newLowCut != lowCut || newHighCut != highCut)
+    {
+        lowCut = newLowCut;
+        highCut = newHighCut;
+        updateCoefficients();
+    }
+}
+
+void FeedbackFilter::updateCoefficients() noexcept
+{
+    sectionsPerFilter = slope == Slope::db48 ? 4 : slope == Slope::db24 ? 2 : 1;
+
+    // The unused lanes up to the register width pass the signal through.
+    int width = kernels != nullptr ? kernels->laneWidth : 1;
+    int usedLanes = 4 * sectionsPerFilter;
+    lanes.numLanes = (usedLanes + width - 1) / width * width;
+
+    const float* resonances = getResonances(slope);
+    double nyquistLimit = 0.49 * sampleRate;
+    double gLow = std::tan(juce::MathConstants<double>::pi * std::min(double(lowCut), nyquistLimit) / sampleRate);
+    double gHigh = std::tan(juce::MathConstants<double>::pi * std::min(double(highCut), nyquistLimit) / sampleRate);
+
+    for (int lane = 0; lane < lanes.numLanes; ++lane)
+    {
+        int section = lane / 2;
+        bool isLowCut = section < sectionsPerFilter;
+        bool isHighCut = !isLowCut && section < 2 * sectionsPerFilter;
+
+        if (isLowCut || isHighCut)
+        {
+            double g = isLowCut ? gLow : gHigh;
+            double R2 = 1.0 / double(resonances[section % sectionsPerFilter]);
+            lanes.g[lane] = float(g);
+            lanes.gR[lane] = float(g + R2);
+            lanes.h[lane] = float(1.0 / (1.0 + R2 * g + g * g));
+            lanes.highpassGain[lane] = isLowCut ? 1.0f : 0.0f;
+            lanes.lowpassGain[lane] = isLowCut ? 0.0f : 1.0f;
+        }
+        else
+        {
+            lanes.g[lane] = 0.0f;
+            lanes.gR[lane] = 0.0f;
+            lanes.h[lane] = 1.0f;
+            lanes.highpassGain[lane] = 1.0f;
+            lanes.lowpassGain[lane] = 0.0f;
+        }
+    }
+}
+
+void FeedbackFilter::processSample(float& left, float& right) noexcept
+{
+    for (int lane = 0; lane < 4 * sectionsPerFilter; ++lane)
+    {
+        float x = (lane & 1) == 0 ? left : right;
+
+        float hp = lanes.h[lane] * (x - lanes.s1[lane] * lanes.gR[lane] - lanes.s2[lane]);
+        float bp = hp * lanes.g[lane] + lanes.s1[lane];
+        float lp = bp * lanes.g[lane] + lanes.s2[lane];
+        lanes.s1[lane] = hp * lanes.g[lane] + bp;
+        lanes.s2[lane] = bp * lanes.g[lane] + lp;
+
+        float y = hp * lanes.highpassGain[lane] + lp * lanes.lowpassGain[lane];
+        ((lane & 1) == 0 ? left : right) = y;
+    }
+}
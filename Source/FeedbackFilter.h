@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    FeedbackFilter.h
+    Created: 19 Oct 2026 3:37:12pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "VectorKernels.h"
+
+// The low cut and high cut in the feedback path, as Butterworth cascades of
+// state variable filters. Both channels and all sections share one set of
+// SIMD lanes, so a steeper slope costs nothing extra until the lanes of the
+// current instruction set are full.
+class FeedbackFilter
+{
+public:
+    enum class Slope
+    {
+        db12,
+        db24,
+        db48,
+    };
+
+    void prepare(double sampleRate, const VectorKernels& kernels) noexcept;
+    void reset() noexcept;
+
+    // A new slope clears the filter state, the old state does not fit the
+    // new sections.
+    void setSlope(Slope newSlope) noexcept;
+    void setCutoffs(float lowCut, float highCut) noexcept;
+
+    // One sample at a time, for the kernels that cannot work on blocks.
+    // Runs the sections one after the other and gives the same result as
+    // the scalar block kernel.
+    void processSample(float& left, float& right) noexcept;
+
+    void process(float* left, float* right, int numSamples) noexcept
+    {
+        kernels->filter(lanes, left, right, numSamples);
+    }
+
+private:
+    void updateCoefficients() noexcept;
+
+    VectorKernels::FilterLanes lanes;
+    const VectorKernels* kernels = nullptr;
+    double sampleRate = 44100.0;
+
+    Slope slope = Slope::db12;
+    int sectionsPerFilter = 1;
+
+    float lowCut = 20.0f;
+    float highCut = 20000.0f;
+};
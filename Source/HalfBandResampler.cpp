@@ -0,0 +1,282 @@
+/*
+  ==============================================================================
+
+    HalfBandResampler.cpp
+    Created: 19 Oct 2026 8:36:27pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "HalfBandResampler.h"
+
+int HalfBandResampler::Stage::getOrder(double sampleRate) noexcept
+{
+    // Kaiser's estimate of the length for 80 dB. The transition band of a
+    // half-band filter is centred on a quarter of the rate, so keeping
+    // 20 kHz fixes where it ends.
+    constexpr double passband = 20000.0;
+    constexpr double attenuation = 80.0;
+    double transition = std::max(0.02, (sampleRate * 0.5 - 2.0 * passband) / sampleRate);
+    double length = (attenuation - 7.95) / (2.285 * juce::MathConstants<double>::twoPi * transition) + 1.0;
+
+    // The length is always 4 * order - 1, so both ends are non-zero taps.
+    return std::max(2, int(std::ceil((length + 1.0) / 4.0)));
+}
+
+void HalfBandResampler::Stage::prepare(Direction direction, double sampleRate, int maxBlockSize)
+{
+    int order = getOrder(sampleRate);
+    int centre = 2 * order - 1;
+
+    // A windowed sinc with its zero crossings on every other tap.
+    constexpr double beta = 7.857;
+    auto bessel = [](double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x * 0.5 / k) * (x * 0.5 / k);
+            sum += term;
+        }
+        return sum;
+    };
+
+    taps.resize(size_t(order));
+    double sum = 0.0;
+    for (int j = 0; j < order; ++j)
+    {
+        double offset = 2 * j + 1;
+        double sinc = (j % 2 == 0 ? 1.0 : -1.0) * 2.0 / (juce::MathConstants<double>::pi * offset);
+        double ratio = offset / centre;
+        double window = bessel(beta * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / bessel(beta);
+        taps[size_t(j)] = float(0.5 * sinc * window);
+        sum += 0.5 * sinc * window;
+    }
+
+    // Exactly unity at DC, together with the centre tap of 1/2.
+    for (auto& tap : taps)
+    {
+        tap = float(double(tap) * 0.25 / sum);
+    }
+
+    historyLength = direction == Direction::down ? 4 * order - 2 : 2 * order - 1;
+    history.setSize(2, historyLength + maxBlockSize);
+    reset();
+}
+
+void HalfBandResampler::Stage::reset() noexcept
+{
+    history.clear();
+    odd = false;
+}
+
+void HalfBandResampler::Stage::append(const float* inputL, const float* inputR, int numSamples) noexcept
+{
+    jassert(historyLength + numSamples <= history.getNumSamples());
+    history.copyFrom(0, historyLength, inputL, numSamples);
+    history.copyFrom(1, historyLength, inputR, numSamples);
+}
+
+void HalfBandResampler::Stage::keepHistory(int numSamples) noexcept
+{
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        float* data = history.getWritePointer(channel);
+        std::memmove(data, data + numSamples, size_t(historyLength) * sizeof(float));
+    }
+}
+
+int HalfBandResampler::Stage::decimate(const float* inputL, const float* inputR, int numSamples,
+                                       float* outputL, float* outputR) noexcept
+{
+    append(inputL, inputR, numSamples);
+
+    int order = int(taps.size());
+    int centre = 2 * order - 1;
+    const float* tap = taps.data();
+    int numOutput = 0;
+
+    // One output for every second sample, centred on the sample that lies
+    // half the filter length behind it. The centre tap is the only odd one.
+    for (int i = odd ? 0 : 1; i < numSamples; i += 2)
+    {
+        const float* xL = history.getReadPointer(0, historyLength + i - centre);
+        const float* xR = history.getReadPointer(1, historyLength + i - centre);
+        float sumL = 0.5f * xL[0];
+        float sumR = 0.5f * xR[0];
+        for (int j = 0; j < order; ++j)
+        {
+            int offset = 2 * j + 1;
+            sumL += tap[j] * (xL[-offset] + xL[offset]);
+            sumR += tap[j] * (xR[-offset] + xR[offset]);
+        }
+        outputL[numOutput] = sumL;
+        outputR[numOutput] = sumR;
+        ++numOutput;
+    }
+
+    odd = (numSamples + (odd ? 1 : 0)) % 2 == 1;
+    keepHistory(numSamples);
+    return numOutput;
+}
+
+void HalfBandResampler::Stage::interpolate(const float* inputL, const float* inputR, int numSamples,
+                                           float* outputL, float* outputR) noexcept
+{
+    append(inputL, inputR, numSamples);
+
+    int order = int(taps.size());
+    const float* tap = taps.data();
+
+    // With zeros between the samples, the even outputs see only the
+    // symmetric taps and the odd ones only the centre tap, which the gain of
+    // 2 that makes up for the zeros turns into a plain copy.
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float* xL = history.getReadPointer(0, historyLength + i - order);
+        const float* xR = history.getReadPointer(1, historyLength + i - order);
+        float sumL = 0.0f;
+        float sumR = 0.0f;
+        for (int j = 0; j < order; ++j)
+        {
+            sumL += tap[j] * (xL[-j] + xL[j + 1]);
+            sumR += tap[j] * (xR[-j] + xR[j + 1]);
+        }
+        outputL[2 * i] = 2.0f * sumL;
+        outputR[2 * i] = 2.0f * sumR;
+        outputL[2 * i + 1] = xL[1];
+        outputR[2 * i + 1] = xR[1];
+    }
+
+    keepHistory(numSamples);
+}
+
+void HalfBandResampler::prepare(Direction direction_, int factor_, double sampleRate, int maxBlockSize)
+{
+    direction = direction_;
+    factor = factor_ == 2 || factor_ == 4 ? factor_ : 1;
+    numStages = factor == 4 ? 2 : factor == 2 ? 1 : 0;
+
+    int maxReduced = maxBlockSize / factor + 1;
+    if (direction == Direction::down)
+    {
+        if (numStages == 2)
+        {
+            stages[0].prepare(direction, sampleRate, maxBlockSize);
+            stages[1].prepare(direction, sampleRate / 2.0, maxBlockSize / 2 + 1);
+        }
+        else if (numStages == 1)
+        {
+            stages[0].prepare(direction, sampleRate, maxBlockSize);
+        }
+        middle.setSize(2, maxBlockSize / 2 + 1);
+    }
+    else
+    {
+        if (numStages == 2)
+        {
+            stages[0].prepare(direction, sampleRate / 2.0, maxReduced);
+            stages[1].prepare(direction, sampleRate, 2 * maxReduced);
+        }
+        else if (numStages == 1)
+        {
+            stages[0].prepare(direction, sampleRate, maxReduced);
+        }
+        middle.setSize(2, 2 * maxReduced);
+    }
+
+    overflow.setSize(2, factor);
+    upsampled.setSize(2, factor * (maxReduced + 1));
+    reset();
+}
+
+void HalfBandResampler::reset() noexcept
+{
+    for (int stage = 0; stage < numStages; ++stage)
+    {
+        stages[size_t(stage)].reset();
+    }
+
+    // Starting with one sample short of a full frame lets every block come
+    // out complete, whatever its size.
+    overflow.clear();
+    numOverflow = factor - 1;
+}
+
+int HalfBandResampler::getLatency(int factor, double sampleRate) noexcept
+{
+    // Every stage delays by half its length on the way down and again on
+    // the way up, and the held back samples add one less than the factor.
+    if (factor == 2)
+    {
+        return 4 * Stage::getOrder(sampleRate) - 2;
+    }
+    if (factor == 4)
+    {
+        return 4 * Stage::getOrder(sampleRate) + 8 * Stage::getOrder(sampleRate / 2.0) - 6;
+    }
+    return 0;
+}
+
+int HalfBandResampler::decimate(const float* inputL, const float* inputR, int numSamples,
+                                float* outputL, float* outputR) noexcept
+{
+    jassert(direction == Direction::down);
+
+    if (numStages == 0)
+    {
+        juce::FloatVectorOperations::copy(outputL, inputL, numSamples);
+        juce::FloatVectorOperations::copy(outputR, inputR, numSamples);
+        return numSamples;
+    }
+    if (numStages == 1)
+    {
+        return stages[0].decimate(inputL, inputR, numSamples, outputL, outputR);
+    }
+
+    float* middleL = middle.getWritePointer(0);
+    float* middleR = middle.getWritePointer(1);
+    int numMiddle = stages[0].decimate(inputL, inputR, numSamples, middleL, middleR);
+    return stages[1].decimate(middleL, middleR, numMiddle, outputL, outputR);
+}
+
+void HalfBandResampler::interpolate(const float* inputL, const float* inputR, int numInput,
+                                    float* outputL, float* outputR, int numSamples) noexcept
+{
+    jassert(direction == Direction::up);
+
+    if (numStages == 0)
+    {
+        jassert(numInput == numSamples);
+        juce::FloatVectorOperations::copy(outputL, inputL, numSamples);
+        juce::FloatVectorOperations::copy(outputR, inputR, numSamples);
+        return;
+    }
+
+    float* upL = upsampled.getWritePointer(0);
+    float* upR = upsampled.getWritePointer(1);
+    juce::FloatVectorOperations::copy(upL, overflow.getReadPointer(0), numOverflow);
+    juce::FloatVectorOperations::copy(upR, overflow.getReadPointer(1), numOverflow);
+
+    if (numStages == 1)
+    {
+        stages[0].interpolate(inputL, inputR, numInput, upL + numOverflow, upR + numOverflow);
+    }
+    else
+    {
+        float* middleL = middle.getWritePointer(0);
+        float* middleR = middle.getWritePointer(1);
+        stages[0].interpolate(inputL, inputR, numInput, middleL, middleR);
+        stages[1].interpolate(middleL, middleR, 2 * numInput, upL + numOverflow, upR + numOverflow);
+    }
+
+    int numAvailable = numOverflow + factor * numInput;
+    jassert(numAvailable >= numSamples && numAvailable - numSamples < factor);
+
+    juce::FloatVectorOperations::copy(outputL, upL, numSamples);
+    juce::FloatVectorOperations::copy(outputR, upR, numSamples);
+    numOverflow = numAvailable - numSamples;
+    juce::FloatVectorOperations::copy(overflow.getWritePointer(0), upL + numSamples, numOverflow);
+    juce::FloatVectorOperations::copy(overflow.getWritePointer(1), upR + numSamples, numOverflow);
+}
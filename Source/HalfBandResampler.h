@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    HalfBandResampler.h
+    Created: 19 Oct 2026 8:36:27pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Divides or multiplies the sample rate of a stereo signal by 2 or 4 with
+// half-band FIR filters in polyphase form.
+//
+// In a half-band filter every other coefficient is zero, apart from the
+// centre one, which is 1/2, and the others are symmetric. A stage never
+// touches the zeros and multiplies each pair of samples that share a
+// coefficient only once, about a quarter of the work of the full filter.
+//
+// Each stage is designed for the rate it runs at. It keeps everything up to
+// 20 kHz and stops anything that would fold back below that by at least
+// 80 dB. The stage at the reduced rate needs a narrow transition band and
+// many taps. At factor 4 the stage in front of it gets away with a few.
+class HalfBandResampler
+{
+public:
+    enum class Direction
+    {
+        down,
+        up,
+    };
+
+    // The sample rate and block size are the ones at the full rate. Factors
+    // other than 2 and 4 pass the signal through untouched.
+    void prepare(Direction direction, int factor, double sampleRate, int maxBlockSize);
+    void reset() noexcept;
+
+    int getFactor() const noexcept
+    {
+        return factor;
+    }
+
+    // Samples at the full rate from going down to coming back up, including
+    // the samples held back so every block comes out complete.
+    static int getLatency(int factor, double sampleRate) noexcept;
+
+    // Down. Returns the number of samples written, which changes from block
+    // to block when the block size is not a multiple of the factor, and is
+    // never more than maxBlockSize / factor + 1.
+    int decimate(const float* inputL, const float* inputR, int numSamples,
+                 float* outputL, float* outputR) noexcept;
+
+    // Up. Always writes numSamples samples, given what decimate returned for
+    // a block of that size.
+    void interpolate(const float* inputL, const float* inputR, int numInput,
+                     float* outputL, float* outputR, int numSamples) noexcept;
+
+private:
+    class Stage
+    {
+    public:
+        // The rate is the higher of the two the stage runs between, and the
+        // block size is the most samples that go in at once.
+        void prepare(Direction direction, double sampleRate, int maxBlockSize);
+        void reset() noexcept;
+
+        // Non-zero coefficients on each side of the centre.
+        static int getOrder(double sampleRate) noexcept;
+
+        int decimate(const float* inputL, const float* inputR, int numSamples,
+                     float* outputL, float* outputR) noexcept;
+
+        // Writes two samples for every one that goes in.
+        void interpolate(const float* inputL, const float* inputR, int numSamples,
+                         float* outputL, float* outputR) noexcept;
+
+    private:
+        void append(const float* inputL, const float* inputR, int numSamples) noexcept;
+        void keepHistory(int numSamples) noexcept;
+
+        std::vector<float> taps;
+
+        // The samples the filter still needs from earlier blocks, followed
+        // by the current block.
+        juce::AudioBuffer<float> history;
+        int historyLength = 0;
+
+        // Whether the next sample in completes a pair when decimating.
+        bool odd = false;
+    };
+
+    // Stages in the order the signal goes through them.
+    std::array<Stage, 2> stages;
+    int numStages = 0;
+    int factor = 1;
+    Direction direction = Direction::down;
+
+    // Between the stages when there are two.
+    juce::AudioBuffer<float> middle;
+
+    // Interpolated samples that did not fit into the last block.
+    juce::AudioBuffer<float> overflow;
+    int numOverflow = 0;
+    juce::AudioBuffer<float> upsampled;
+};
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+    HistoryCapture.cpp
+    Created: 19 Oct 2026 6:21:08pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "HistoryCapture.h"
+#include "Trace.h"
+
+HistoryCapture::WriterThread::WriterThread()
+    : juce::TimeSliceThread("History capture writer")
+{
+    startThread(juce::Thread::Priority::background);
+}
+
+HistoryCapture::WriterThread::~WriterThread()
+{
+    stopThread(5000);
+}
+
+HistoryCapture::HistoryCapture()
+{
+    writer->addTimeSliceClient(this);
+}
+
+HistoryCapture::~HistoryCapture()
+{
+    // Waits for a write in progress to finish.
+    writer->removeTimeSliceClient(this);
+
+    delete pending.exchange(nullptr);
+    delete finished.exchange(nullptr);
+    delete active;
+}
+
+bool HistoryCapture::request(const juce::File& file, int numSamples, double sampleRate)
+{
+    bool expected = false;
+    if (numSamples <= 0 || !busy.compare_exchange_strong(expected, true))
+    {
+        return false;
+    }
+
+    lastResult.store(Result::none);
+    auto* job = new Job();
+    job->file = file;
+    job->audio.setSize(2, numSamples);
+    job->sampleRate = sampleRate;
+    pending.store(job, std::memory_order_release);
+    return true;
+}
+
+void HistoryCapture::process(const DelayBuffer& history, int blockSize) noexcept
+{
+    if (active == nullptr)
+    {
+        active = pending.exchange(nullptr, std::memory_order_acquire);
+        if (active == nullptr)
+        {
+            return;
+        }
+        active->endPosition = history.getNumWritten();
+
+        // The history may have been prepared shorter since the request.
+        if (active->audio.getNumSamples() >= history.getSize())
+        {
+            active->audio.setSize(2, history.getSize() - 1, false, false, true);
+        }
+    }
+
+    DELAY_TRACE_ZONE("history capture");
+
+    int length = active->audio.getNumSamples();
+    int sliceSize = std::min(length - active->numCopied, std::max(2 * blockSize, minSliceSize));
+
+    // How far back the oldest sample that is still missing sits now.
+    auto age = history.getNumWritten() - active->endPosition + (length - active->numCopied);
+    jassert(age < history.getSize());
+
+    history.copyHistory(active->audio.getWritePointer(0, active->numCopied),
+                        active->audio.getWritePointer(1, active->numCopied),
+                        int(age), sliceSize);
+    active->numCopied += sliceSize;
+
+    if (active->numCopied == length)
+    {
+        finished.store(active, std::memory_order_release);
+        active = nullptr;
+    }
+}
+
+void HistoryCapture::cancel() noexcept
+{
+    // While a copy runs nothing else is pending or finished, so the capture
+    // is over once it is gone.
+    if (active != nullptr)
+    {
+        delete active;
+        active = nullptr;
+        busy.store(false);
+    }
+}
+
+int HistoryCapture::useTimeSlice()
+{
+    if (auto* job = finished.exchange(nullptr, std::memory_order_acquire))
+    {
+        bool success = write(*job);
+        delete job;
+        lastResult.store(success ? Result::written : Result::failed);
+        busy.store(false);
+    }
+
+    // Polling keeps the audio thread out of any locks. A capture that is
+    // not running only needs an occasional look.
+    return isBusy() ? 50 : 250;
+}
+
+bool HistoryCapture::write(const Job& job)
+{
+    std::unique_ptr<juce::AudioFormat> format;
+    if (job.file.hasFileExtension("flac"))
+    {
+        format = std::make_unique<juce::FlacAudioFormat>();
+    }
+    else
+    {
+        format = std::make_unique<juce::WavAudioFormat>();
+    }
+
+    job.file.deleteFile();
+    auto stream = std::make_unique<juce::FileOutputStream>(job.file);
+    if (stream->failedToOpen())
+    {
+        return false;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> fileWriter(
+        format->createWriterFor(stream.get(), job.sampleRate, 2, 24, {}, 0));
+    if (fileWriter == nullptr)
+    {
+        return false;
+    }
+    stream.release();
+
+    return fileWriter->writeFromAudioSampleBuffer(job.audio, 0, job.audio.getNumSamples());
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    HistoryCapture.h
+    Created: 19 Oct 2026 6:21:08pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "DelayBuffer.h"
+
+// Saves the last seconds of a delay history to a file while audio keeps
+// running.
+//
+// The message thread allocates the job and hands it to the audio thread
+// through an atomic pointer. The audio thread copies one slice per block,
+// oldest samples first and at least twice as fast as the history moves on,
+// so the copy always stays ahead of the writes that would overwrite them.
+// The finished job goes back the same way, and a writer thread shared by
+// all instances encodes it as WAV, or FLAC if the file says so.
+class HistoryCapture : private juce::TimeSliceClient
+{
+public:
+    HistoryCapture();
+    ~HistoryCapture() override;
+
+    // Message thread. Returns false while an earlier capture is running.
+    bool request(const juce::File& file, int numSamples, double sampleRate);
+
+    // True from the request until the file has been written.
+    bool isBusy() const noexcept
+    {
+        return busy.load();
+    }
+
+    enum class Result
+    {
+        none,
+        written,
+        failed
+    };
+
+    // How the last capture ended, none while it runs or before the first.
+    // The writer thread sets it just before the capture stops being busy,
+    // for the editor to poll.
+    Result getLastResult() const noexcept
+    {
+        return lastResult.load();
+    }
+
+    // Audio thread, once per block after the history has been written.
+    // Never blocks or allocates.
+    void process(const DelayBuffer& history, int blockSize) noexcept;
+
+    // Drops a copy in progress. The history is about to be reallocated, so
+    // this is called while the audio thread is stopped.
+    void cancel() noexcept;
+
+private:
+    struct Job
+    {
+        juce::File file;
+        juce::AudioBuffer<float> audio;
+        double sampleRate = 44100.0;
+        juce::int64 endPosition = 0;
+        int numCopied = 0;
+    };
+
+    class WriterThread : public juce::TimeSliceThread
+    {
+    public:
+        WriterThread();
+        ~WriterThread() override;
+    };
+
+    // Big enough to copy a full history in a few seconds even with tiny
+    // blocks, small enough not to show in the block time.
+    static constexpr int minSliceSize = 16384;
+
+    int useTimeSlice() override;
+    static bool write(const Job& job);
+
+    std::atomic<Job*> pending { nullptr };
+    std::atomic<Job*> finished { nullptr };
+    Job* active = nullptr;
+    std::atomic<bool> busy { false };
+    std::atomic<Result> lastResult { Result::none };
+
+    juce::SharedResourcePointer<WriterThread> writer;
+
+    JUCE_DECLARE_NON_COPYABLE(HistoryCapture)
+};
@@ -10,23 +10,44 @@
 
 #include "LookAndFeel.h"
 
-const juce::Typeface::Ptr Fonts::typeface = juce::Typeface::createSystemTypefaceFor(
-                                            BinaryData::FSEX300_ttf, BinaryData::FSEX300_ttfSize);
+UIResources::UIResources()
+    : typeface(juce::Typeface::createSystemTypefaceFor(BinaryData::FSEX300_ttf, BinaryData::FSEX300_ttfSize)),
+      logo(juce::ImageFileFormat::loadFrom(BinaryData::logo_png, BinaryData::logo_pngSize))
+{
+}
 
-juce::Font Fonts::getFont(float height)
+juce::Font UIResources::getFont(float height) const
 {
     return juce::FontOptions(typeface)
                     .withMetricsKind(juce::TypefaceMetricsKind::legacy)
                     .withHeight(height);
 }
 
+const juce::Image& UIResources::getLogo(float scale)
+{
+    // The asset is twice the drawn size, so it is used as it is on HiDPI
+    // screens and only resampled for lower scales.
+    if (scale >= 2.0f)
+    {
+        return logo;
+    }
+    if (scale != scaledLogoScale)
+    {
+        auto size = getLogoSize().toFloat() * scale;
+        scaledLogo = logo.rescaled(juce::roundToInt(size.x), juce::roundToInt(size.y),
+                                   juce::Graphics::highResamplingQuality);
+        scaledLogoScale = scale;
+    }
+    return scaledLogo;
+}
+
 juce::Font RotaryKnobLookAndFeel::getLabelFont([[maybe_unused]] juce::Label& label)
 {
-    return Fonts::getFont();
+    return resources.getFont();
 }
 
 
-RotaryKnobLookAndFeel::RotaryKnobLookAndFeel()
+RotaryKnobLookAndFeel::RotaryKnobLookAndFeel(UIResources& resources_) : resources(resources_)
 {
     setColour(juce::Label::textColourId, Colors::Knob::label);
     setColour(juce::Slider::textBoxTextColourId, Colors::Knob::label);
@@ -85,7 +106,7 @@ void RotaryKnobLookAndFeel::fillTextEditorBackground(juce::Graphics& g,
     g.fillRoundedRectangle(textEditor.getLocalBounds().reduced(4, 0).toFloat(), 4.0f);
 }
 
-MainLookAndFeel::MainLookAndFeel()
+MainLookAndFeel::MainLookAndFeel(UIResources& resources_) : resources(resources_)
 {
     setColour(juce::GroupComponent::textColourId, Colors::Group::label);
     setColour(juce::GroupComponent::outlineColourId, Colors::Group::outline);
@@ -93,17 +114,25 @@ MainLookAndFeel::MainLookAndFeel()
 
 juce::Font MainLookAndFeel::getLabelFont([[maybe_unused]] juce::Label& label)
 {
-    return Fonts::getFont();
+    return resources.getFont();
 }
 
-void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics& g,
-                                             int x, int y, int width, [[maybe_unused]] int height,
-                                             float sliderPos,
-                                             float rotaryStartAngle, float rotaryEndAngle,
-                                             juce::Slider& slider)
+const juce::Image& RotaryKnobLookAndFeel::getKnobBody(int size, float scale)
 {
-    auto bounds = juce::Rectangle<int>(x, y, width, width).toFloat();
-    auto knobRect = bounds.reduced(10.0f, 10.0f);
+    for (const auto& body : knobBodies)
+    {
+        if (body.size == size && body.scale == scale)
+        {
+            return body.image;
+        }
+    }
+    
+    int pixels = juce::roundToInt(float(size) * scale);
+    juce::Image image(juce::Image::ARGB, pixels, pixels, true);
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    
+    auto knobRect = juce::Rectangle<float>(0.0f, 0.0f, float(size), float(size)).reduced(10.0f, 10.0f);
     
     auto path = juce::Path();
     path.addEllipse(knobRect);
@@ -112,13 +141,29 @@ void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics& g,
     g.setColour(Colors::Knob::outline);
     g.fillEllipse(knobRect);
     
-    auto innerRect = knobRect.reduced(2.0f, 2.0f); 
+    auto innerRect = knobRect.reduced(2.0f, 2.0f);
     auto gradient = juce::ColourGradient(
         Colors::Knob::gradientTop, 0.0f, innerRect.getY(),
-        Colors::Knob::gradientBottom, 0.0f, innerRect.getBottom(), false); 
+        Colors::Knob::gradientBottom, 0.0f, innerRect.getBottom(), false);
     g.setGradientFill(gradient);
     g.fillEllipse(innerRect);
     
+    knobBodies.add({ size, scale, image });
+    return knobBodies.getReference(knobBodies.size() - 1).image;
+}
+
+void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics& g,
+                                             int x, int y, int width, [[maybe_unused]] int height,
+                                             float sliderPos,
+                                             float rotaryStartAngle, float rotaryEndAngle,
+                                             juce::Slider& slider)
+{
+    auto bounds = juce::Rectangle<int>(x, y, width, width).toFloat();
+    auto innerRect = bounds.reduced(12.0f, 12.0f);
+    
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    g.drawImage(getKnobBody(width, scale), bounds);
+    
     auto center = bounds.getCentre();
     auto radius = bounds.getWidth() / 2.0f;
     auto lineWidth = 3.0f;
@@ -176,7 +221,7 @@ void RotaryKnobLookAndFeel::drawRotarySlider(juce::Graphics& g,
 
 }
 
-ButtonLookAndFeel::ButtonLookAndFeel()
+ButtonLookAndFeel::ButtonLookAndFeel(UIResources& resources_) : resources(resources_)
 {
     setColour(juce::TextButton::textColourOffId, Colors::Button::text);
     setColour(juce::TextButton::textColourOnId, Colors::Button::textToggled);
@@ -225,7 +270,7 @@ void ButtonLookAndFeel::drawButtonText(
         g.setColour(button.findColour(juce::TextButton::textColourOffId));
     }
 
-    g.setFont(Fonts::getFont());
+    g.setFont(resources.getFont());
     g.drawText(button.getButtonText(), buttonRect, juce::Justification::centred);
 }
 
@@ -12,10 +12,15 @@
 
 #include <JuceHeader.h>
 
+// The font and logo come from the plugin project's generated resources.
+// DelayTool builds the editor too and compiles the same BinaryData.cpp.
+#include "../JuceLibraryCode/BinaryData.h"
+
 namespace Colors
 {
     const juce::Colour background { 245, 240, 235 };
     const juce::Colour header { 40, 40, 40 };
+    const juce::Colour warning { 220, 60, 60 };
 
     namespace Button
     {
@@ -47,29 +52,24 @@ namespace Colors
     
     }
 
-}
+    namespace Waveform
+    {
+        const juce::Colour background { 250, 245, 240 };
+        const juce::Colour peak { 177, 101, 135 };
+        const juce::Colour segmentStart { 225, 215, 210 };
+        const juce::Colour writeHead { 80, 80, 80 };
+        const juce::Colour forwardHead { 40, 40, 40 };
+        const juce::Colour reverseHead { 220, 60, 60 };
+    }
 
-class Fonts
-{
-    Fonts() = delete;
-    
-public:
-    static juce::Font getFont(float height = 16.0f);
+}
 
-private:
-    static const juce::Typeface::Ptr typeface;
-};
+class UIResources;
 
 class RotaryKnobLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    RotaryKnobLookAndFeel();
-    
-    static RotaryKnobLookAndFeel* get()
-    {
-        static RotaryKnobLookAndFeel instance;
-        return &instance;
-    }
+    explicit RotaryKnobLookAndFeel(UIResources& resources);
     
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
                           float sliderPos, float rotaryStartAngle,
@@ -88,6 +88,19 @@ public:
                                   juce::TextEditor&) override;
 private:
     
+    // The shadow, rim and gradient of a knob never change, so they are
+    // rendered once per size and display scale and then only blitted.
+    const juce::Image& getKnobBody(int size, float scale);
+    
+    struct KnobBody
+    {
+        int size;
+        float scale;
+        juce::Image image;
+    };
+    juce::Array<KnobBody> knobBodies;
+    
+    UIResources& resources;
     juce::DropShadow dropShadow { Colors::Knob::dropShadow, 6, { 0, 3 } };
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RotaryKnobLookAndFeel)
     
@@ -96,24 +109,19 @@ private:
 class MainLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    MainLookAndFeel();
+    explicit MainLookAndFeel(UIResources& resources);
     
     juce::Font getLabelFont(juce::Label&) override;
     
 private:
+    UIResources& resources;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainLookAndFeel)
 };
 
 class ButtonLookAndFeel : public juce::LookAndFeel_V4
 {
 public:
-    ButtonLookAndFeel();
-
-    static ButtonLookAndFeel* get()
-    {
-        static ButtonLookAndFeel instance;
-        return &instance;
-    }
+    explicit ButtonLookAndFeel(UIResources& resources);
 
     void drawButtonBackground(juce::Graphics& g, juce::Button& button,
                               const juce::Colour& backgroundColour,
@@ -125,5 +133,38 @@ public:
                         bool shouldDrawButtonAsDown) override;
 
 private:
+    UIResources& resources;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ButtonLookAndFeel)
 };
+
+// Everything the editor draws with that is costly to create, shared by all
+// plugin instances in the process. Editors and knobs hold it through a
+// juce::SharedResourcePointer, so it is built when the first editor opens,
+// not when the library is loaded or scanned, and released again when the
+// last editor closes.
+class UIResources
+{
+public:
+    UIResources();
+    
+    juce::Font getFont(float height = 16.0f) const;
+    
+    // The logo at its drawn size, resampled once for the display scale.
+    const juce::Image& getLogo(float scale);
+    juce::Point<int> getLogoSize() const noexcept
+    {
+        return { logo.getWidth() / 2, logo.getHeight() / 2 };
+    }
+    
+    MainLookAndFeel mainLookAndFeel { *this };
+    RotaryKnobLookAndFeel rotaryKnobLookAndFeel { *this };
+    ButtonLookAndFeel buttonLookAndFeel { *this };
+    
+private:
+    juce::Typeface::Ptr typeface;
+    juce::Image logo;
+    juce::Image scaledLogo;
+    float scaledLogoScale = 0.0f;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UIResources)
+};
@@ -0,0 +1,310 @@
+/*
+  ==============================================================================
+
+    MemoryPool.cpp
+    Created: 19 Oct 2026 10:14:38pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "MemoryPool.h"
+
+#if JUCE_WINDOWS
+ #ifndef NOMINMAX
+  #define NOMINMAX
+ #endif
+ #include <windows.h>
+#else
+ #include <sys/mman.h>
+#endif
+
+#if JUCE_LINUX
+ #include <cinttypes>
+ #include <fstream>
+#endif
+
+MemoryPool::Slab::Slab(Slab&& other) noexcept
+    : pool(std::exchange(other.pool, nullptr)),
+      data(std::exchange(other.data, nullptr)),
+      numBytes(std::exchange(other.numBytes, 0)),
+      classBytes(std::exchange(other.classBytes, 0)),
+      hugePages(std::exchange(other.hugePages, false))
+{
+}
+
+MemoryPool::Slab& MemoryPool::Slab::operator=(Slab&& other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        pool = std::exchange(other.pool, nullptr);
+        data = std::exchange(other.data, nullptr);
+        numBytes = std::exchange(other.numBytes, 0);
+        classBytes = std::exchange(other.classBytes, 0);
+        hugePages = std::exchange(other.hugePages, false);
+    }
+    return *this;
+}
+
+MemoryPool::Slab::~Slab()
+{
+    reset();
+}
+
+void MemoryPool::Slab::reset() noexcept
+{
+    if (data != nullptr)
+    {
+        pool->release(*this);
+    }
+    pool = nullptr;
+    data = nullptr;
+    numBytes = 0;
+    classBytes = 0;
+    hugePages = false;
+}
+
+//==============================================================================
+MemoryPool::MemoryPool()
+{
+    useHugePages = juce::SystemStats::getEnvironmentVariable("DELAY_HUGE_PAGES", "1") != "0";
+}
+
+MemoryPool::~MemoryPool()
+{
+    // Every slab holds a reference to the pool through its owner, so they
+    // have all come back by now.
+    jassert(stats.numSlabs == 0);
+    if (cached.data != nullptr)
+    {
+        unmap(cached);
+    }
+}
+
+size_t MemoryPool::getClassSize(size_t numBytes) noexcept
+{
+    constexpr size_t pageSize = 4096;
+    size_t granule = numBytes >= hugePageSize ? hugePageSize : pageSize;
+    return (numBytes + granule - 1) / granule * granule;
+}
+
+MemoryPool::Slab MemoryPool::allocate(size_t numBytes)
+{
+    Slab slab;
+    if (numBytes == 0)
+    {
+        return slab;
+    }
+
+    size_t classBytes = getClassSize(numBytes);
+    Mapping mapping;
+    {
+        const juce::ScopedLock sl(lock);
+        if (cached.data != nullptr && cached.numBytes == classBytes)
+        {
+            mapping = std::exchange(cached, Mapping());
+            stats.bytesCached -= classBytes;
+            ++stats.numReused;
+        }
+    }
+
+    // Mapping and touching happen outside the lock, so instances preparing
+    // on different threads do not wait for each other.
+    bool reused = mapping.data != nullptr;
+    if (!reused)
+    {
+        mapping = map(classBytes);
+        if (mapping.data == nullptr)
+        {
+            return slab;
+        }
+    }
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+    if (reused)
+    {
+        std::memset(mapping.data, 0, numBytes);
+    }
+    else
+    {
+        touch(mapping.data, classBytes);
+    }
+    double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    {
+        const juce::ScopedLock sl(lock);
+        ++stats.numSlabs;
+        stats.bytesInUse += classBytes;
+        stats.secondsPrefaulting += elapsed;
+        if (!reused)
+        {
+            ++stats.numMapped;
+            if (mapping.hugePages)
+            {
+                stats.bytesHugePagesRequested += classBytes;
+                hugeMappings.push_back(mapping);
+            }
+        }
+    }
+
+    slab.pool = this;
+    slab.data = mapping.data;
+    slab.numBytes = numBytes;
+    slab.classBytes = classBytes;
+    slab.hugePages = mapping.hugePages;
+    return slab;
+}
+
+void MemoryPool::release(Slab& slab) noexcept
+{
+    // The slab given back takes the place of the one cached before.
+    Mapping evicted { slab.data, slab.classBytes, slab.hugePages };
+    {
+        const juce::ScopedLock sl(lock);
+        --stats.numSlabs;
+        stats.bytesInUse -= evicted.numBytes;
+        stats.bytesCached += evicted.numBytes;
+        std::swap(cached, evicted);
+
+        if (evicted.data != nullptr)
+        {
+            stats.bytesCached -= evicted.numBytes;
+            ++stats.numUnmapped;
+            if (evicted.hugePages)
+            {
+                stats.bytesHugePagesRequested -= evicted.numBytes;
+                hugeMappings.erase(std::find_if(hugeMappings.begin(), hugeMappings.end(),
+                                                [&](const Mapping& mapping) { return mapping.data == evicted.data; }));
+            }
+        }
+    }
+
+    if (evicted.data != nullptr)
+    {
+        unmap(evicted);
+    }
+}
+
+MemoryPool::Stats MemoryPool::getStats() const
+{
+    const juce::ScopedLock sl(lock);
+    Stats current = stats;
+    current.bytesHugePagesBacked = getBackedHugePageBytes(hugeMappings);
+    return current;
+}
+
+MemoryPool::Mapping MemoryPool::map(size_t numBytes) const
+{
+    Mapping mapping;
+    mapping.numBytes = numBytes;
+    bool wantsHugePages = useHugePages && numBytes % hugePageSize == 0;
+
+   #if JUCE_WINDOWS
+    SIZE_T largePageSize = GetLargePageMinimum();
+    if (wantsHugePages && largePageSize > 0 && numBytes % largePageSize == 0)
+    {
+        // Needs the privilege to lock pages in memory, and simply fails
+        // without it.
+        mapping.data = VirtualAlloc(nullptr, numBytes, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        mapping.hugePages = mapping.data != nullptr;
+    }
+    if (mapping.data == nullptr)
+    {
+        mapping.data = VirtualAlloc(nullptr, numBytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    }
+   #else
+    #if defined(MADV_HUGEPAGE)
+    if (wantsHugePages)
+    {
+        // Transparent huge pages need a range aligned to them, so the
+        // mapping is made one huge page longer and trimmed at both ends.
+        size_t padded = numBytes + hugePageSize;
+        void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw != MAP_FAILED)
+        {
+            auto start = reinterpret_cast<std::uintptr_t>(raw);
+            auto aligned = (start + hugePageSize - 1) & ~std::uintptr_t(hugePageSize - 1);
+            size_t head = aligned - start;
+            size_t tail = padded - head - numBytes;
+            if (head > 0)
+            {
+                munmap(raw, head);
+            }
+            if (tail > 0)
+            {
+                munmap(reinterpret_cast<void*>(aligned + numBytes), tail);
+            }
+            mapping.data = reinterpret_cast<void*>(aligned);
+            mapping.hugePages = madvise(mapping.data, numBytes, MADV_HUGEPAGE) == 0;
+        }
+    }
+    #endif
+    if (mapping.data == nullptr)
+    {
+        void* raw = mmap(nullptr, numBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        mapping.data = raw != MAP_FAILED ? raw : nullptr;
+    }
+   #endif
+
+    // Pages are far larger than the alignment the kernels need.
+    jassert(reinterpret_cast<std::uintptr_t>(mapping.data) % alignment == 0);
+    return mapping;
+}
+
+void MemoryPool::unmap(const Mapping& mapping) noexcept
+{
+   #if JUCE_WINDOWS
+    VirtualFree(mapping.data, 0, MEM_RELEASE);
+   #else
+    munmap(mapping.data, mapping.numBytes);
+   #endif
+}
+
+void MemoryPool::touch(void* data, size_t numBytes) noexcept
+{
+    // Fresh pages read as zero, so one zero written into each faults it in
+    // without clearing it again.
+    auto* bytes = static_cast<volatile char*>(data);
+    for (size_t offset = 0; offset < numBytes; offset += 4096)
+    {
+        bytes[offset] = 0;
+    }
+}
+
+size_t MemoryPool::getBackedHugePageBytes(const std::vector<Mapping>& mappings)
+{
+    size_t numBytes = 0;
+   #if JUCE_WINDOWS
+    for (const auto& mapping : mappings)
+    {
+        numBytes += mapping.numBytes;
+    }
+   #elif JUCE_LINUX
+    // Each region starts with a line giving its address range, followed by
+    // its counters. Neighbouring mappings with the same flags can share a
+    // region, which is then counted once.
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool overlaps = false;
+    while (std::getline(smaps, line))
+    {
+        std::uintptr_t start = 0, end = 0;
+        if (std::sscanf(line.c_str(), "%" SCNxPTR "-%" SCNxPTR, &start, &end) == 2)
+        {
+            overlaps = std::any_of(mappings.begin(), mappings.end(), [&](const Mapping& mapping)
+            {
+                auto first = reinterpret_cast<std::uintptr_t>(mapping.data);
+                return first < end && start < first + mapping.numBytes;
+            });
+        }
+        else if (overlaps && line.rfind("AnonHugePages:", 0) == 0)
+        {
+            numBytes += size_t(std::strtoull(line.c_str() + 14, nullptr, 10)) * 1024;
+        }
+    }
+   #else
+    juce::ignoreUnused(mappings);
+   #endif
+    return numBytes;
+}
@@ -0,0 +1,137 @@
+/*
+  ==============================================================================
+
+    MemoryPool.h
+    Created: 19 Oct 2026 10:14:38pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Hands out the large, long-lived buffers of the delay histories, shared by
+// every instance in the process through juce::SharedResourcePointer.
+//
+// Slabs come straight from the operating system, 64-byte aligned, cleared,
+// and with every page already written, so the first block after
+// prepareToPlay never stops for page faults. Slabs of 2 MB and more are
+// rounded up to whole huge pages and ask for them where the system has
+// them: transparent huge pages on Linux and large pages on Windows when the
+// user may lock memory. DELAY_HUGE_PAGES=0 turns that off.
+//
+// The last slab that is given back is kept for the next request of the
+// same size class, which is what an instance preparing again asks for. Any
+// older free slab goes back to the system then, so the pool never holds
+// more than one slab nobody uses. Once the last instance is gone the pool
+// is destroyed and returns that one too.
+class MemoryPool
+{
+public:
+    MemoryPool();
+    ~MemoryPool();
+
+    static constexpr size_t alignment = 64;
+    static constexpr size_t hugePageSize = 2 * 1024 * 1024;
+
+    // Memory from the pool, given back when the slab is reset or destroyed.
+    // The pool must outlive it, which holding the SharedResourcePointer next
+    // to the slab takes care of.
+    class Slab
+    {
+    public:
+        Slab() = default;
+        Slab(Slab&& other) noexcept;
+        Slab& operator=(Slab&& other) noexcept;
+        ~Slab();
+
+        void reset() noexcept;
+
+        template<typename Type>
+        Type* getData() const noexcept
+        {
+            return static_cast<Type*>(data);
+        }
+
+        size_t getNumBytes() const noexcept
+        {
+            return numBytes;
+        }
+
+    private:
+        friend class MemoryPool;
+
+        MemoryPool* pool = nullptr;
+        void* data = nullptr;
+        size_t numBytes = 0;
+        size_t classBytes = 0;
+        bool hugePages = false;
+
+        JUCE_DECLARE_NON_COPYABLE(Slab)
+    };
+
+    // Not for the audio thread. Takes the cached slab if it is of the size
+    // class and clears it, or maps and touches a new one. Returns an empty
+    // slab when the system has no memory to give, for the caller to cope
+    // with.
+    Slab allocate(size_t numBytes);
+
+    struct Stats
+    {
+        int numSlabs = 0;
+        size_t bytesInUse = 0;
+        size_t bytesCached = 0;
+
+        // Of the bytes in use and cached, those in slabs that asked for
+        // huge pages and got the mapping for them. On Linux that is only a
+        // hint, and the kernel may still back them with small pages.
+        size_t bytesHugePagesRequested = 0;
+
+        // Of those, the bytes the system actually backs with huge pages:
+        // AnonHugePages in /proc/self/smaps on Linux, and all of them on
+        // Windows, where large pages are committed as such or not at all.
+        size_t bytesHugePagesBacked = 0;
+
+        // Slabs mapped from and returned to the system, and requests served
+        // from the cache.
+        juce::int64 numMapped = 0;
+        juce::int64 numUnmapped = 0;
+        juce::int64 numReused = 0;
+
+        // Time spent clearing and touching pages, all of it in prepareToPlay.
+        double secondsPrefaulting = 0.0;
+    };
+
+    Stats getStats() const;
+
+private:
+    struct Mapping
+    {
+        void* data = nullptr;
+        size_t numBytes = 0;
+        bool hugePages = false;
+    };
+
+    // Rounds up to whole pages, or to whole huge pages from hugePageSize on.
+    static size_t getClassSize(size_t numBytes) noexcept;
+
+    Mapping map(size_t numBytes) const;
+    static void unmap(const Mapping& mapping) noexcept;
+    static void touch(void* data, size_t numBytes) noexcept;
+    static size_t getBackedHugePageBytes(const std::vector<Mapping>& mappings);
+    void release(Slab& slab) noexcept;
+
+    bool useHugePages = true;
+
+    juce::CriticalSection lock;
+    Mapping cached;
+    Stats stats;
+
+    // The slabs in use or cached that asked for huge pages, to look up how
+    // the system backs them.
+    std::vector<Mapping> hugeMappings;
+
+    JUCE_DECLARE_NON_COPYABLE(MemoryPool)
+};
@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    MultiLaneDelay.cpp
+    Created: 19 Oct 2026 9:24:51pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "MultiLaneDelay.h"
+
+bool MultiLaneDelay::prepare(int newNumLanes, int maxDelayInSamples, int newMaxBlockSize, const VectorKernels& newKernels)
+{
+    kernels = &newKernels;
+    numLanes = juce::jlimit(0, maxLanes, newNumLanes);
+
+    if (numLanes == 0)
+    {
+        releaseMemory();
+        return true;
+    }
+
+    // One row for the sample being written and one for the older neighbour
+    // of the longest delay, as in DelayBuffer.
+    int stride = (2 * numLanes + 15) / 16 * 16;
+    int size = maxDelayInSamples + 2;
+
+    bool resized = stride != lanes.stride || size != lanes.size || lanes.history == nullptr;
+    if (resized)
+    {
+        // Cleared, with every page touched before playback.
+        history.reset();
+        history = pool->allocate(size_t(size) * size_t(stride) * sizeof(float));
+        lanes.history = history.getData<float>();
+        lanes.stride = stride;
+        lanes.size = size;
+        lanes.writeIndex = 0;
+    }
+
+    if (resized || newMaxBlockSize != maxBlockSize)
+    {
+        maxBlockSize = newMaxBlockSize;
+        frames.reset();
+        frames = pool->allocate(size_t(maxBlockSize) * size_t(stride) * sizeof(float));
+        frameData = frames.getData<float>();
+    }
+
+    if (lanes.history == nullptr || frameData == nullptr)
+    {
+        releaseMemory();
+        return false;
+    }
+
+    // With every value at zero, the voices past the used channels write and
+    // output nothing, whatever their columns still hold.
+    for (float* values : { lanes.delay, lanes.delayStep, lanes.feedback, lanes.feedbackStep, lanes.pan,
+                           lanes.panStep, lanes.dryGain, lanes.dryGainStep, lanes.wetGain, lanes.wetGainStep })
+    {
+        std::fill_n(values, VectorKernels::DelayLanes::maxVoices, 0.0f);
+    }
+
+    targets = {};
+    started = false;
+    reset();
+    return true;
+}
+
+void MultiLaneDelay::releaseMemory() noexcept
+{
+    history.reset();
+    frames.reset();
+    lanes.history = nullptr;
+    lanes.size = 0;
+    frameData = nullptr;
+    maxBlockSize = 0;
+}
+
+void MultiLaneDelay::reset() noexcept
+{
+    if (lanes.history == nullptr)
+    {
+        return;
+    }
+
+    // The first sample after the reset interpolates towards the newest row
+    // before it, which is therefore the only one cleared.
+    int newest = lanes.writeIndex == 0 ? lanes.size - 1 : lanes.writeIndex - 1;
+    std::fill_n(lanes.history + newest * lanes.stride, lanes.stride, 0.0f);
+    lanes.numValid = 0;
+}
+
+size_t MultiLaneDelay::getNumBytes() const noexcept
+{
+    return lanes.history != nullptr ? size_t(lanes.size) * size_t(lanes.stride) * sizeof(float) : 0;
+}
+
+void MultiLaneDelay::setLane(int lane, const Lane& values) noexcept
+{
+    jassert(lane >= 0 && lane < numLanes);
+    targets[size_t(lane)] = values;
+}
+
+void MultiLaneDelay::process(float* const* channels, int numSamples) noexcept
+{
+    jassert(numSamples <= maxBlockSize || lanes.history == nullptr);
+    if (numLanes == 0 || numSamples <= 0 || lanes.history == nullptr)
+    {
+        return;
+    }
+
+    // Every value ramps from where the last block left it to its target.
+    // The first block has nothing to ramp from.
+    float rampScale = started ? 1.0f / float(numSamples) : 0.0f;
+    float maxDelay = float(lanes.size - 2);
+    auto ramp = [&](float* current, float* step, int voice, float target)
+    {
+        if (!started)
+        {
+            current[voice] = target;
+        }
+        step[voice] = (target - current[voice]) * rampScale;
+    };
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        const auto& target = targets[size_t(lane)];
+        float delay = juce::jlimit(1.0f, maxDelay, target.delayInSamples);
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            int voice = 2 * lane + channel;
+            ramp(lanes.delay, lanes.delayStep, voice, delay);
+            ramp(lanes.feedback, lanes.feedbackStep, voice, target.feedback);
+            ramp(lanes.pan, lanes.panStep, voice, channel == 0 ? target.panL : target.panR);
+            ramp(lanes.dryGain, lanes.dryGainStep, voice, target.dryGain);
+            ramp(lanes.wetGain, lanes.wetGainStep, voice, target.wetGain);
+        }
+    }
+
+    // The padding voices keep a valid delay and no gain.
+    for (int voice = 2 * numLanes; voice < lanes.stride; ++voice)
+    {
+        lanes.delay[voice] = 1.0f;
+        lanes.delayStep[voice] = 0.0f;
+    }
+    started = true;
+
+    int numChannels = 2 * numLanes;
+    int stride = lanes.stride;
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* source = channels[channel];
+        for (int i = 0; i < numSamples; ++i)
+        {
+            frameData[i * stride + channel] = source[i];
+        }
+    }
+
+    kernels->delayLanes(lanes, frameData, numSamples);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        float* dest = channels[channel];
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] = frameData[i * stride + channel];
+        }
+    }
+
+    // The steps add up to the targets only approximately, so the next block
+    // starts exactly on them.
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        const auto& target = targets[size_t(lane)];
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            int voice = 2 * lane + channel;
+            lanes.delay[voice] = juce::jlimit(1.0f, maxDelay, target.delayInSamples);
+            lanes.feedback[voice] = target.feedback;
+            lanes.pan[voice] = channel == 0 ? target.panL : target.panR;
+            lanes.dryGain[voice] = target.dryGain;
+            lanes.wetGain[voice] = target.wetGain;
+        }
+    }
+}
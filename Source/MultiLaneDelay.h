@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+
+    MultiLaneDelay.h
+    Created: 19 Oct 2026 9:24:51pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "VectorKernels.h"
+#include "MemoryPool.h"
+
+// Up to 16 independent stereo delays in one engine, for a main bus with more
+// than two channels: lane n runs on channels 2n and 2n + 1. Each lane is the
+// forward engine without filters, with its own delay, feedback, pan and
+// gains.
+//
+// The lanes share one history with a frame of all channels per sample, so
+// the kernel advances a whole register of voices at the same sample with
+// each instruction, instead of running one instance after the other.
+//
+// Like DelayBuffer, resetting takes constant time and the history reads as
+// silence until it has been overwritten.
+class MultiLaneDelay
+{
+public:
+    static constexpr int maxLanes = VectorKernels::DelayLanes::maxVoices / 2;
+
+    // Preparing with no lanes frees the memory. Preparing again with the same
+    // sizes keeps it and only resets it. Returns false if the pool had no
+    // memory for the lanes, which then process nothing.
+    bool prepare(int numLanes, int maxDelayInSamples, int maxBlockSize, const VectorKernels& kernels);
+    void reset() noexcept;
+
+    int getNumLanes() const noexcept
+    {
+        return numLanes;
+    }
+
+    size_t getNumBytes() const noexcept;
+
+    struct Lane
+    {
+        float delayInSamples = 1.0f;
+        float feedback = 0.0f;
+        float panL = 0.0f;
+        float panR = 1.0f;
+        float dryGain = 1.0f;
+        float wetGain = 0.0f;
+    };
+
+    // The values a lane reaches at the end of the next block. It ramps to
+    // them across the block, apart from the first block after prepare,
+    // which starts on them.
+    void setLane(int lane, const Lane& values) noexcept;
+
+    // Processes one block of every lane in place. channels holds two
+    // channels per lane, and numSamples is at most the prepared block size.
+    void process(float* const* channels, int numSamples) noexcept;
+
+private:
+    const VectorKernels* kernels = nullptr;
+    VectorKernels::DelayLanes lanes;
+    int numLanes = 0;
+
+    // Slabs from the pool start on the 64 bytes the widest kernel loads
+    // with, so the rows line up with no further rounding.
+    juce::SharedResourcePointer<MemoryPool> pool;
+    MemoryPool::Slab history;
+    MemoryPool::Slab frames;
+    float* frameData = nullptr;
+    int maxBlockSize = 0;
+    void releaseMemory() noexcept;
+
+    std::array<Lane, maxLanes> targets {};
+    bool started = false;
+};
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    OnsetDetector.cpp
+    Created: 19 Oct 2026 11:48:22am
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "OnsetDetector.h"
+
+void OnsetDetector::prepare(double newSampleRate) noexcept
+{
+    sampleRate = newSampleRate;
+
+    // The running average follows the hop energies with a 100 ms time constant.
+    double hopsPerSecond = sampleRate / hopSize;
+    averageCoeff = float(1.0 - std::exp(-1.0 / (0.1 * hopsPerSecond)));
+
+    setHoldOff(100.0f);
+    reset();
+}
+
+void OnsetDetector::reset() noexcept
+{
+    hopEnergy = 0.0f;
+    hopPosition = 0;
+    averageDecibels = -100.0f;
+    previousDecibels = -100.0f;
+    samplesSinceOnset = holdOffSamples;
+    attackPower = 0.0f;
+    attackStart = -1;
+}
+
+void OnsetDetector::setHoldOff(float milliseconds) noexcept
+{
+    holdOffSamples = int(milliseconds * 0.001 * sampleRate);
+}
+
+int OnsetDetector::process(const float* left, const float* right, int numSamples) noexcept
+{
+    int numOnsets = 0;
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        float mono = (left[sample] + right[sample]) * 0.5f;
+        float power = mono * mono;
+        hopEnergy += power;
+
+        if (attackStart < 0 && power > attackPower)
+        {
+            attackStart = hopPosition;
+        }
+
+        if (++hopPosition < hopSize)
+        {
+            continue;
+        }
+
+        float meanPower = hopEnergy / float(hopSize);
+        float decibels = 10.0f * std::log10(meanPower + 1e-10f);
+        hopEnergy = 0.0f;
+        hopPosition = 0;
+
+        // An onset is a hop that is clearly louder than the recent average,
+        // still rising, and far enough away from the previous onset.
+        bool onset = decibels > floorDecibels
+                  && decibels - averageDecibels > threshold
+                  && decibels > previousDecibels
+                  && samplesSinceOnset >= holdOffSamples;
+
+        if (onset && numOnsets < maxOnsetsPerBlock)
+        {
+            onsets[size_t(numOnsets)] = sample;
+            attackLengths[size_t(numOnsets++)] = hopSize - std::max(0, attackStart);
+            samplesSinceOnset = 0;
+        }
+
+        averageDecibels += (decibels - averageDecibels) * averageCoeff;
+        previousDecibels = decibels;
+        samplesSinceOnset = std::min(samplesSinceOnset + hopSize, holdOffSamples);
+        attackPower = meanPower * thresholdRatio;
+        attackStart = -1;
+    }
+
+    return numOnsets;
+}
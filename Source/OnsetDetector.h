@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    OnsetDetector.h
+    Created: 19 Oct 2026 11:48:22am
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Finds transients by comparing the energy of short hops against a slower
+// running average. Costs one log per hop, so it can run on every instance.
+class OnsetDetector
+{
+public:
+    static constexpr int hopSize = 64;
+    static constexpr int maxOnsetsPerBlock = 32;
+
+    void prepare(double sampleRate) noexcept;
+    void reset() noexcept;
+    void setHoldOff(float milliseconds) noexcept;
+
+    // Analyses a block and returns how many onsets were found. Each onset is
+    // reported at the last sample of the hop it was detected in, so the
+    // transient itself started at most hopSize samples earlier.
+    int process(const float* left, const float* right, int numSamples) noexcept;
+
+    int getOnset(int index) const noexcept
+    {
+        return onsets[size_t(index)];
+    }
+
+    // The samples of the hop that belong to the transient, counted back from
+    // the onset. The attack starts at the first sample that is more than the
+    // threshold louder than the hop before, or at the start of the hop if
+    // none is.
+    int getAttackLength(int index) const noexcept
+    {
+        return attackLengths[size_t(index)];
+    }
+
+private:
+    double sampleRate = 44100.0;
+
+    float hopEnergy = 0.0f;
+    int hopPosition = 0;
+
+    float averageDecibels = -100.0f;
+    float previousDecibels = -100.0f;
+    float averageCoeff = 0.0f;
+
+    int holdOffSamples = 0;
+    int samplesSinceOnset = 0;
+
+    // The power a sample needs to start an attack, from the hop before, and
+    // where in the current hop the first such sample was.
+    float attackPower = 0.0f;
+    int attackStart = -1;
+
+    std::array<int, maxOnsetsPerBlock> onsets {};
+    std::array<int, maxOnsetsPerBlock> attackLengths {};
+
+    // In decibels and as a power ratio.
+    static constexpr float threshold = 9.0f;
+    static constexpr float thresholdRatio = 7.943282f;
+    static constexpr float floorDecibels = -60.0f;
+};
@@ -10,6 +10,7 @@
 
 #include "Parameters.h"
 #include "DSP.h"
+#include "Trace.h"
 
 template<typename T>
 static void castParameter(juce::AudioProcessorValueTreeState& apvts, const juce::ParameterID& id, T& destination)
@@ -82,87 +83,151 @@ Parameters::Parameters(juce::AudioProcessorValueTreeState& apvts)
     castParameter(apvts, stereoParamID, stereoParam);
     castParameter(apvts, lowCutParamID, lowCutParam);
     castParameter(apvts, highCutParamID, highCutParam);
+    castParameter(apvts, feedbackSlopeParamID, feedbackSlopeParam);
     castParameter(apvts, tempoSyncParamID, tempoSyncParam);
     castParameter(apvts, delayNoteParamID, delayNoteParam);
+    castParameter(apvts, lookaheadParamID, lookaheadParam);
+    castParameter(apvts, reverseTriggerParamID, reverseTriggerParam);
+    castParameter(apvts, reverseFadeParamID, reverseFadeParam);
+    castParameter(apvts, spectralParamID, spectralParam);
+    castParameter(apvts, freezeParamID, freezeParam);
+    castParameter(apvts, blurParamID, blurParam);
+    castParameter(apvts, reverbParamID, reverbParam);
+    castParameter(apvts, bypassParamID, bypassParam);
+    
+    static_assert(numSmoothers <= SmootherBank::maxSmoothers);
+    smoothers.setCurve(gainSmoother, SmootherBank::Curve::multiplicative, 0.02);
+    smoothers.setCurve(delayTimeSmoother, SmootherBank::Curve::onePole, 0.2);
+    smoothers.setCurve(mixSmoother, SmootherBank::Curve::linear, 0.02);
+    smoothers.setCurve(feedbackSmoother, SmootherBank::Curve::linear, 0.02);
+    smoothers.setCurve(stereoSmoother, SmootherBank::Curve::linear, 0.02);
+    smoothers.setCurve(lowCutSmoother, SmootherBank::Curve::multiplicative, 0.02);
+    smoothers.setCurve(highCutSmoother, SmootherBank::Curve::multiplicative, 0.02);
 }
 
 void Parameters::update() noexcept
 {
-    gainSmoother.setTargetValue(juce::Decibels::decibelsToGain(gainParam->get()));
+    DELAY_TRACE_ZONE("Parameters::update");
+    smoothers.setTarget(gainSmoother, juce::Decibels::decibelsToGain(gainParam->get()));
+    smoothers.setTarget(delayTimeSmoother, delayTimeParam->get());
+    smoothers.setTarget(mixSmoother, mixParam->get() * 0.01f);
+    smoothers.setTarget(feedbackSmoother, feedbackParam->get() * 0.01f);
+    smoothers.setTarget(stereoSmoother, stereoParam->get() * 0.01f);
+    smoothers.setTarget(lowCutSmoother, lowCutParam->get());
+    smoothers.setTarget(highCutSmoother, highCutParam->get());
     
-    targetDelayTime = delayTimeParam->get();
-    if (delayTime == 0.0f)
-    {
-        delayTime = targetDelayTime;
-    }
-    
-    mixSmoother.setTargetValue(mixParam->get() * 0.01f);
-    
-    feedbackSmoother.setTargetValue(feedbackParam->get() * 0.01f);
-    
-    stereoSmoother.setTargetValue(stereoParam->get() * 0.01f);
-    
-    lowCutSmoother.setTargetValue(lowCutParam->get());
-    highCutSmoother.setTargetValue(highCutParam->get());
+    feedbackSlope = feedbackSlopeParam->getIndex();
     
     delayNote = delayNoteParam->getIndex();
     tempoSync = tempoSyncParam->get();
+    lookahead = lookaheadParam->get();
+    reverseTrigger = reverseTriggerParam->get();
+    reverseFade = reverseFadeParam->get();
+    
+    spectral = spectralParam->get();
+    freeze = freezeParam->get();
+    blur = blurParam->get() * 0.01f;
+    
+    reverb = reverbParam->get();
     
 }
 
+void Parameters::limitDelayTime(float maxTime) noexcept
+{
+    if (getTargetDelayTime() > maxTime)
+    {
+        smoothers.setTarget(delayTimeSmoother, maxTime);
+    }
+}
+
 void Parameters::prepareToPlay(double sampleRate) noexcept
 {
-    double duration = 0.02;
-    gainSmoother.reset(sampleRate, duration);
-    feedbackSmoother.reset(sampleRate, duration);
-    stereoSmoother.reset(sampleRate, duration);
-    lowCutSmoother.reset(sampleRate, duration);
-    highCutSmoother.reset(sampleRate, duration);
-    
-    coeff = 1.0f - std::exp(-1.0f / (0.2f * float(sampleRate)));
-    
-    mix = 1.0f;
-    mixSmoother.setCurrentAndTargetValue(mixParam->get() * 0.01f);
-    
-    
+    smoothers.prepare(sampleRate);
 }
 
 void Parameters::reset() noexcept
 {
-    gain = 0.0f;
-    delayTime = 0.0f;
-    feedback = 0.0f;
-    
-    lowCut = 20.0f;
-    lowCutSmoother.setCurrentAndTargetValue(lowCutParam->get());
-    
-    highCut = 20000.0f;
-    highCutSmoother.setCurrentAndTargetValue(highCutParam->get());
-    
-    gainSmoother.setCurrentAndTargetValue(juce::Decibels::decibelsToGain(gainParam->get()));
-    
-    feedbackSmoother.setCurrentAndTargetValue(feedbackParam->get() * 0.01f);
-    
-    stereoSmoother.setCurrentAndTargetValue(stereoParam->get() * 0.01f);
-    
-    float panL = 0.0f;
-    float panR = 1.0f;
+    smoothers.setCurrentAndTarget(gainSmoother, juce::Decibels::decibelsToGain(gainParam->get()));
+    smoothers.setCurrentAndTarget(delayTimeSmoother, delayTimeParam->get());
+    smoothers.setCurrentAndTarget(mixSmoother, mixParam->get() * 0.01f);
+    smoothers.setCurrentAndTarget(feedbackSmoother, feedbackParam->get() * 0.01f);
+    smoothers.setCurrentAndTarget(stereoSmoother, stereoParam->get() * 0.01f);
+    smoothers.setCurrentAndTarget(lowCutSmoother, lowCutParam->get());
+    smoothers.setCurrentAndTarget(highCutSmoother, highCutParam->get());
+    
+    stereo = smoothers.getCurrentValue(stereoSmoother);
+    panningEqualPower(stereo, panL, panR);
+    updateValues();
 }
 
 void Parameters::smoothen() noexcept
 {
-    gain = gainSmoother.getNextValue();
-    
-    delayTime += (targetDelayTime - delayTime) * coeff;
-    
-    mix = mixSmoother.getNextValue();
-    
-    feedback = feedbackSmoother.getNextValue();
-    
-    panningEqualPower(stereoSmoother.getNextValue(), panL, panR);
+    smoothers.next();
+    updateValues();
+}
+
+void Parameters::renderOutputRamps(float* gains, float* mixes, int numSamples) noexcept
+{
+    std::array<float*, SmootherBank::maxSmoothers> destinations {};
+    destinations[gainSmoother] = gains;
+    destinations[mixSmoother] = mixes;
+    smoothers.render(destinations.data(), numSamples);
+    updateValues();
+}
+
+void Parameters::skip(int numSamples) noexcept
+{
+    std::array<float*, SmootherBank::maxSmoothers> destinations {};
+    smoothers.render(destinations.data(), numSamples);
+    updateValues();
+}
+
+void Parameters::updateValues() noexcept
+{
+    gain = smoothers.getCurrentValue(gainSmoother);
+    delayTime = smoothers.getCurrentValue(delayTimeSmoother);
+    mix = smoothers.getCurrentValue(mixSmoother);
+    feedback = smoothers.getCurrentValue(feedbackSmoother);
+    lowCut = smoothers.getCurrentValue(lowCutSmoother);
+    highCut = smoothers.getCurrentValue(highCutSmoother);
+    
+    // The pan law needs a sine and a cosine, so it only runs when it has to.
+    float newStereo = smoothers.getCurrentValue(stereoSmoother);
+    if (newStereo != stereo)
+    {
+        stereo = newStereo;
+        panningEqualPower(stereo, panL, panR);
+    }
+}
+
+bool Parameters::isSmoothing(bool includeDelayTime) const noexcept
+{
+    if (smoothers.isSettled())
+    {
+        return false;
+    }
     
-    lowCut = lowCutSmoother.getNextValue();
-    highCut = highCutSmoother.getNextValue();
+    for (int i = 0; i < numSmoothers; ++i)
+    {
+        if (smoothers.isSmoothing(i) && (includeDelayTime || i != delayTimeSmoother))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool Parameters::isOnlyOutputSmoothing(bool includeDelayTime) const noexcept
+{
+    for (int i = 0; i < numSmoothers; ++i)
+    {
+        bool isOutput = i == gainSmoother || i == mixSmoother || (!includeDelayTime && i == delayTimeSmoother);
+        if (smoothers.isSmoothing(i) && !isOutput)
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout Parameters::createParameterLayout()
@@ -263,6 +328,51 @@ juce::AudioProcessorValueTreeState::ParameterLayout Parameters::createParameterL
                                                             noteLengths,
                                                             9));
     
+    // Parameters added since the first release go after the original ones,
+    // in the order they were added, so the indices of the older parameters
+    // stay the same for hosts that address them by index.
+    layout.add(std::make_unique<juce::AudioParameterBool>
+               (lookaheadParamID, "Reverse Lookahead", false));
+    
+    layout.add(std::make_unique<juce::AudioParameterBool>
+               (reverseTriggerParamID, "Reverse Onset Trigger", false));
+    
+    layout.add(std::make_unique<juce::AudioParameterBool>
+               (spectralParamID, "Spectral Reverse", false));
+    
+    layout.add(std::make_unique<juce::AudioParameterBool>
+               (freezeParamID, "Spectral Freeze", false));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+    blurParamID,
+    "Spectral Blur",
+    juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f),
+    0.0f,
+    juce::AudioParameterFloatAttributes().withStringFromValueFunction(stringFromPercent)
+    ));
+    
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+                                                            feedbackSlopeParamID,
+                                                            "Feedback Slope",
+                                                            juce::StringArray { "12 dB/oct", "24 dB/oct", "48 dB/oct" },
+                                                            0));
+    
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+    reverseFadeParamID,
+    "Reverse Crossfade",
+    juce::NormalisableRange<float>(0.0f, 200.0f, 0.1f, 0.5f),
+    20.0f,
+    juce::AudioParameterFloatAttributes().withStringFromValueFunction(stringFromMilliseconds)
+    ));
+    
+    layout.add(std::make_unique<juce::AudioParameterBool>(
+                                                          bypassParamID,
+                                                          "Bypass",
+                                                          false));
+    
+    layout.add(std::make_unique<juce::AudioParameterBool>
+               (reverbParamID, "Reverse Reverb", false));
+    
     return layout;
         
 }
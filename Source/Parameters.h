@@ -10,20 +10,36 @@
 
 #pragma once
 #include <JuceHeader.h>
+#include "SmootherBank.h"
 
 const juce::ParameterID gainParamID { "gain", 1 };
-const juce::ParameterID delayTimeParamID { "delayTime", 1 };
+
+// The delay time used to stop at 5 s under the legacy ID. Hosts would map
+// its automation onto the 60 s range, so it has a new ID, and sessions that
+// still use the old one are moved over when they are loaded.
+const juce::ParameterID delayTimeParamID { "delayTimeLong", 1 };
+const juce::ParameterID legacyDelayTimeParamID { "delayTime", 1 };
+
 const juce::ParameterID mixParamID { "mix", 1 };
 const juce::ParameterID feedbackParamID { "feedback", 1 };
 const juce::ParameterID stereoParamID { "stereo", 1 };
 
 const juce::ParameterID lowCutParamID { "lowCut", 1 };
 const juce::ParameterID highCutParamID { "highCut", 1 };
+const juce::ParameterID feedbackSlopeParamID { "feedbackSlope", 1 };
 
 const juce::ParameterID tempoSyncParamID { "tempoSync", 1 };
 const juce::ParameterID delayNoteParamID { "delayNote", 1 };
 
 inline static const juce::ParameterID reverseDelayParamID { "reverseDelay", 1 };
+const juce::ParameterID reverseFadeParamID { "reverseFade", 1 };
+const juce::ParameterID lookaheadParamID { "lookahead", 1 };
+const juce::ParameterID reverseTriggerParamID { "reverseTrigger", 1 };
+const juce::ParameterID spectralParamID { "spectral", 1 };
+const juce::ParameterID freezeParamID { "freeze", 1 };
+const juce::ParameterID blurParamID { "blur", 1 };
+const juce::ParameterID reverbParamID { "reverb", 1 };
+const juce::ParameterID bypassParamID { "bypass", 1 };
 
 
 class Parameters
@@ -39,12 +55,32 @@ public:
     float panL = 0.0f;
     float panR = 1.0f;
     
+    // The smoothed Stereo parameter from -1 to 1, which panL and panR
+    // follow.
+    float getStereo() const noexcept
+    {
+        return stereo;
+    }
+    
     float lowCut = 20.0f;
     float highCut = 20000.0f;
+    int feedbackSlope = 0;
     void update() noexcept;
     
     int delayNote = 0;
     bool tempoSync = false;
+    bool lookahead = false;
+    bool reverseTrigger = false;
+    
+    // Length of the crossfade between the forward and reverse engines in ms.
+    float reverseFade = 20.0f;
+    
+    bool spectral = false;
+    bool freeze = false;
+    float blur = 0.0f;
+    
+    // Replaces the delay engines with the reverse reverb.
+    bool reverb = false;
     
     
     
@@ -55,39 +91,81 @@ public:
     void reset() noexcept;
     void smoothen() noexcept;
     
+    // Renders the output gain and mix for the next numSamples samples and
+    // moves every smoother past them. The public values end up as they
+    // would after calling smoothen() numSamples times.
+    void renderOutputRamps(float* gains, float* mixes, int numSamples) noexcept;
+    
+    // The same without rendering anything.
+    void skip(int numSamples) noexcept;
+    
+    // True while any smoother is still ramping towards its target. The delay
+    // time is ignored when tempo sync overrides it.
+    bool isSmoothing(bool includeDelayTime) const noexcept;
+    
+    // True if the output gain and the mix are the only values still ramping.
+    bool isOnlyOutputSmoothing(bool includeDelayTime) const noexcept;
+    
+    float getTargetDelayTime() const noexcept
+    {
+        return smoothers.getTargetValue(delayTimeSmoother);
+    }
+    
+    // Holds the delay time at maxTime until the next update, for a history
+    // that has not grown to the time set yet.
+    void limitDelayTime(float maxTime) noexcept;
+    
     static constexpr float minDelayTime = 5.0f;
-    static constexpr float maxDelayTime = 5000.0f;
+    static constexpr float maxDelayTime = 60000.0f;
     
     juce::AudioParameterBool* reverseDelayParam;
     juce::AudioParameterBool* tempoSyncParam;
     
+    // Exposed to the host as the plugin's own bypass switch.
+    juce::AudioParameterBool* bypassParam;
+    
 private:
     juce::AudioParameterFloat* gainParam;
     juce::AudioParameterFloat* delayTimeParam;
-    juce::LinearSmoothedValue<float> gainSmoother;
-    
     juce::AudioParameterFloat* mixParam;
-    juce::LinearSmoothedValue<float> mixSmoother;
-    
     juce::AudioParameterFloat* feedbackParam;
-    juce::LinearSmoothedValue<float> feedbackSmoother;
-    
     juce::AudioParameterFloat* stereoParam;
-    juce::LinearSmoothedValue<float> stereoSmoother;
-    
     juce::AudioParameterFloat* lowCutParam;
-    juce::LinearSmoothedValue<float> lowCutSmoother;
-    
     juce::AudioParameterFloat* highCutParam;
-    juce::LinearSmoothedValue<float> highCutSmoother;
     
+    // Lanes of the smoother bank.
+    enum Smoother
+    {
+        gainSmoother,
+        delayTimeSmoother,
+        mixSmoother,
+        feedbackSmoother,
+        stereoSmoother,
+        lowCutSmoother,
+        highCutSmoother,
+        numSmoothers,
+    };
+    SmootherBank smoothers;
+    
+    // Copies the smoothed values into the public members.
+    void updateValues() noexcept;
+    float stereo = 0.0f;
+    
+    juce::AudioParameterChoice* feedbackSlopeParam;
     
     juce::AudioParameterChoice* delayNoteParam;
+    juce::AudioParameterBool* lookaheadParam;
+    juce::AudioParameterBool* reverseTriggerParam;
+    juce::AudioParameterFloat* reverseFadeParam;
+    
+    juce::AudioParameterBool* spectralParam;
+    juce::AudioParameterBool* freezeParam;
+    juce::AudioParameterFloat* blurParam;
+    
+    juce::AudioParameterBool* reverbParam;
     
     
     
     
     
-    float targetDelayTime = 0.0f;
-    float coeff = 0.0f;
 };
@@ -0,0 +1,232 @@
+/*
+  ==============================================================================
+
+    Pipeline.cpp
+    Created: 19 Oct 2026 7:02:44pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "Pipeline.h"
+#include "Trace.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+class Pipeline::Worker : public juce::Thread
+{
+public:
+    Worker(Pipeline& owner_, int numChannels, int maxBlockSize)
+        : juce::Thread("Delay pipeline"), owner(owner_), work(numChannels, maxBlockSize)
+    {
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            if (hasWork())
+            {
+                owner.processNextBlock(work);
+                continue;
+            }
+
+            // A short spin catches blocks that arrive back to back without a
+            // trip through the scheduler.
+            bool woken = false;
+            for (int i = 0; i < workerSpinCount && !woken; ++i)
+            {
+                pause();
+                woken = hasWork();
+            }
+            if (woken)
+            {
+                continue;
+            }
+
+            // The flag goes up before the last look, and the host queues the
+            // block before it checks the flag, so one of them always sees
+            // the other.
+            owner.workerParked.store(true);
+            if (!hasWork())
+            {
+                owner.wakeUp.wait(100.0);
+            }
+            owner.workerParked.store(false);
+        }
+    }
+
+    static void pause() noexcept
+    {
+       #if JUCE_INTEL
+        _mm_pause();
+       #endif
+    }
+
+private:
+    bool hasWork() const noexcept
+    {
+        return owner.numBlocksDone.load(std::memory_order_relaxed) != owner.numBlocksSubmitted.load();
+    }
+
+    Pipeline& owner;
+    juce::AudioBuffer<float> work;
+};
+
+Pipeline::Pipeline() = default;
+
+Pipeline::~Pipeline()
+{
+    release();
+}
+
+void Pipeline::prepare(int numInputChannels_, int numChannels, int maxBlockSize, double sampleRate, Callback callback_)
+{
+    release();
+
+    callback = std::move(callback_);
+    latency = std::max(1, maxBlockSize);
+    numInputChannels = numInputChannels_;
+
+    // The host thread waits until at most one block of input is outstanding
+    // before it reads, so neither ring ever holds more than two blocks.
+    inputRing.setSize(numInputChannels, 2 * latency);
+    inputRing.clear();
+    outputRing.setSize(numChannels, 2 * latency);
+    outputRing.clear();
+
+    numSubmitted = 0;
+    numDelivered = 0;
+    numBlocksSubmitted.store(0);
+    numBlocksDone.store(0);
+    numProcessed.store(0);
+    workerParked.store(false);
+    wakeUp.reset();
+
+    // The host thread spins on the worker, so the worker has to run at the
+    // same priority to keep it from being preempted by anything in between.
+    worker = std::make_unique<Worker>(*this, numChannels, latency);
+    auto options = juce::Thread::RealtimeOptions().withApproximateAudioProcessingTime(latency, sampleRate);
+    if (!worker->startRealtimeThread(options))
+    {
+        worker->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void Pipeline::release()
+{
+    if (worker != nullptr)
+    {
+        worker->signalThreadShouldExit();
+        wakeUp.signal();
+        worker->stopThread(1000);
+        worker.reset();
+    }
+}
+
+template<typename Condition>
+void Pipeline::spinUntil(Condition condition) noexcept
+{
+    for (int i = 0; !condition(); ++i)
+    {
+        if (i < hostSpinCount)
+        {
+            Worker::pause();
+        }
+        else
+        {
+            juce::Thread::yield();
+        }
+    }
+}
+
+void Pipeline::process(juce::AudioBuffer<float>& buffer, const Position& position, bool hostBypass) noexcept
+{
+    DELAY_TRACE_ZONE("pipeline handoff");
+    int numSamples = buffer.getNumSamples();
+    int numChannels = std::min(buffer.getNumChannels(), outputRing.getNumChannels());
+
+    // Blocks longer than announced in prepareToPlay go through in pieces, so
+    // the latency stays the same.
+    for (int start = 0; start < numSamples; start += latency)
+    {
+        int length = std::min(latency, numSamples - start);
+
+        auto blockIndex = numBlocksSubmitted.load(std::memory_order_relaxed);
+        spinUntil([&] { return blockIndex - numBlocksDone.load(std::memory_order_acquire) < maxQueuedBlocks; });
+
+        copyToRing(inputRing, numSubmitted, buffer, start,
+                   std::min(numInputChannels, buffer.getNumChannels()), length);
+        blocks[size_t(blockIndex % maxQueuedBlocks)] = { position, length, hostBypass };
+        numSubmitted += length;
+        numBlocksSubmitted.store(blockIndex + 1);
+
+        if (workerParked.exchange(false))
+        {
+            wakeUp.signal();
+        }
+
+        // The output that goes back now came in one latency ago.
+        auto needed = numDelivered + length - latency;
+        spinUntil([&] { return numProcessed.load(std::memory_order_acquire) >= needed; });
+
+        copyFromRing(outputRing, numDelivered, buffer, start, numChannels, length);
+        numDelivered += length;
+    }
+}
+
+void Pipeline::processNextBlock(juce::AudioBuffer<float>& work) noexcept
+{
+    auto blockIndex = numBlocksDone.load(std::memory_order_relaxed);
+    const auto& block = blocks[size_t(blockIndex % maxQueuedBlocks)];
+    auto position = numProcessed.load(std::memory_order_relaxed);
+
+    juce::AudioBuffer<float> chunk(work.getArrayOfWritePointers(), work.getNumChannels(), block.numSamples);
+    copyFromRing(inputRing, position, chunk, 0, numInputChannels, block.numSamples);
+    for (int channel = numInputChannels; channel < chunk.getNumChannels(); ++channel)
+    {
+        chunk.clear(channel, 0, block.numSamples);
+    }
+
+    callback(chunk, block.position, block.hostBypass);
+
+    copyToRing(outputRing, position + latency, chunk, 0, outputRing.getNumChannels(), block.numSamples);
+    numProcessed.store(position + block.numSamples, std::memory_order_release);
+    numBlocksDone.store(blockIndex + 1, std::memory_order_release);
+}
+
+void Pipeline::copyToRing(juce::AudioBuffer<float>& ring, juce::int64 position,
+                          const juce::AudioBuffer<float>& source, int startSample, int numChannels, int numSamples) noexcept
+{
+    int size = ring.getNumSamples();
+    int index = int(position % size);
+    int first = std::min(numSamples, size - index);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        ring.copyFrom(channel, index, source, channel, startSample, first);
+        if (first < numSamples)
+        {
+            ring.copyFrom(channel, 0, source, channel, startSample + first, numSamples - first);
+        }
+    }
+}
+
+void Pipeline::copyFromRing(const juce::AudioBuffer<float>& ring, juce::int64 position,
+                            juce::AudioBuffer<float>& dest, int startSample, int numChannels, int numSamples) noexcept
+{
+    int size = ring.getNumSamples();
+    int index = int(position % size);
+    int first = std::min(numSamples, size - index);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        dest.copyFrom(channel, startSample, ring, channel, index, first);
+        if (first < numSamples)
+        {
+            dest.copyFrom(channel, startSample + first, ring, channel, 0, numSamples - first);
+        }
+    }
+}
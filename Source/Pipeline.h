@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    Pipeline.h
+    Created: 19 Oct 2026 7:02:44pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Runs the engines of one instance on a worker thread, one block behind the
+// host.
+//
+// The host thread only queues the input of a block and takes the output of
+// the one before it back out, so the engines run alongside the rest of the
+// host's graph instead of inside this node. The price is a fixed latency of
+// one block.
+//
+// Audio and blocks go through preallocated rings, each index written by one
+// side only. The worker runs at audio priority. The host thread never waits
+// on a lock: when the worker is behind it spins and then yields, and it only
+// signals the worker's event once the worker has gone to sleep on it.
+class Pipeline
+{
+public:
+    using Position = juce::Optional<juce::AudioPlayHead::PositionInfo>;
+    using Callback = std::function<void(juce::AudioBuffer<float>& buffer, const Position& position, bool hostBypass)>;
+
+    Pipeline();
+    ~Pipeline();
+
+    // Allocates the rings and starts the worker, which then calls the
+    // callback for every queued block. Audio must be stopped.
+    void prepare(int numInputChannels, int numChannels, int maxBlockSize, double sampleRate, Callback callback);
+
+    // Stops the worker. Audio must be stopped.
+    void release();
+
+    bool isRunning() const noexcept
+    {
+        return worker != nullptr;
+    }
+
+    int getLatency() const noexcept
+    {
+        return isRunning() ? latency : 0;
+    }
+
+    // Host thread. Queues the block and replaces it with the output from one
+    // block earlier. Never allocates.
+    void process(juce::AudioBuffer<float>& buffer, const Position& position, bool hostBypass) noexcept;
+
+private:
+    struct Block
+    {
+        Position position;
+        int numSamples = 0;
+        bool hostBypass = false;
+    };
+
+    class Worker;
+
+    // Blocks are never longer than the latency, so the queue only runs this
+    // deep when the host sends very short ones.
+    static constexpr int maxQueuedBlocks = 64;
+
+    // Pause instructions before the host thread starts yielding, and before
+    // an idle worker goes to sleep.
+    static constexpr int hostSpinCount = 4096;
+    static constexpr int workerSpinCount = 256;
+
+    template<typename Condition>
+    static void spinUntil(Condition condition) noexcept;
+
+    static void copyToRing(juce::AudioBuffer<float>& ring, juce::int64 position,
+                           const juce::AudioBuffer<float>& source, int startSample, int numChannels, int numSamples) noexcept;
+    static void copyFromRing(const juce::AudioBuffer<float>& ring, juce::int64 position,
+                             juce::AudioBuffer<float>& dest, int startSample, int numChannels, int numSamples) noexcept;
+
+    // Worker thread.
+    void processNextBlock(juce::AudioBuffer<float>& work) noexcept;
+
+    Callback callback;
+    int latency = 0;
+    int numInputChannels = 0;
+
+    // Sample positions count from prepare. The output ring starts with one
+    // block of silence, so output position p + latency holds the result of
+    // input position p.
+    juce::AudioBuffer<float> inputRing;
+    juce::AudioBuffer<float> outputRing;
+    std::array<Block, maxQueuedBlocks> blocks;
+
+    // Host thread only.
+    juce::int64 numSubmitted = 0;
+    juce::int64 numDelivered = 0;
+
+    // Written by the host thread.
+    std::atomic<juce::int64> numBlocksSubmitted { 0 };
+
+    // Written by the worker.
+    std::atomic<juce::int64> numBlocksDone { 0 };
+    std::atomic<juce::int64> numProcessed { 0 };
+
+    std::atomic<bool> workerParked { false };
+    juce::WaitableEvent wakeUp;
+    std::unique_ptr<Worker> worker;
+
+    JUCE_DECLARE_NON_COPYABLE(Pipeline)
+};
@@ -26,8 +26,14 @@ DelayAudioProcessorEditor::DelayAudioProcessorEditor (DelayAudioProcessor& p)
     tempoSyncButton.setButtonText("Sync");
     tempoSyncButton.setClickingTogglesState(true);
     tempoSyncButton.setBounds(0, 0, 70, 27);
-    tempoSyncButton.setLookAndFeel(ButtonLookAndFeel::get());
+    tempoSyncButton.setLookAndFeel(&resources->buttonLookAndFeel);
     delayGroup.addAndMakeVisible(tempoSyncButton);
+    
+    lookaheadButton.setButtonText("Ahead");
+    lookaheadButton.setClickingTogglesState(true);
+    lookaheadButton.setBounds(0, 0, 70, 27);
+    lookaheadButton.setLookAndFeel(&resources->buttonLookAndFeel);
+    delayGroup.addAndMakeVisible(lookaheadButton);
     addAndMakeVisible(delayGroup);
     
     feedbackGroup.setText("Feedback");
@@ -46,27 +52,44 @@ DelayAudioProcessorEditor::DelayAudioProcessorEditor (DelayAudioProcessor& p)
     outputGroup.addAndMakeVisible(mixKnob);
     addAndMakeVisible(outputGroup);
     
+    captureButton.setButtonText("Capture");
+    captureButton.setBounds(0, 0, 70, 27);
+    captureButton.setLookAndFeel(&resources->buttonLookAndFeel);
+    captureButton.onClick = [this] { showCaptureMenu(); };
+    addAndMakeVisible(captureButton);
+    
+    addAndMakeVisible(waveformDisplay);
+    
     // Einem Knob eine eigene Farbe zuweisen.
     // gainKnob.slider.setColour(juce::Slider::rotarySliderFillColourId,
     //                           juce::Colours::blue);
     
-    setLookAndFeel(&mainLF);
+    setLookAndFeel(&resources->mainLookAndFeel);
     
-    setSize (500, 330);
+    setSize (500, 410);
     
     updateDelayKnobs(audioProcessor.params.tempoSyncParam->get());
     audioProcessor.params.tempoSyncParam->addListener(this);
+    
+    numCorruptBlocks = audioProcessor.getNumCorruptBlocks();
+    outOfMemory = audioProcessor.isOutOfMemory();
+    updateCaptureButton();
+    startTimerHz(4);
 }
 
 DelayAudioProcessorEditor::~DelayAudioProcessorEditor()
 {
     audioProcessor.params.tempoSyncParam->removeListener(this);
+    tempoSyncButton.setLookAndFeel(nullptr);
+    lookaheadButton.setLookAndFeel(nullptr);
+    captureButton.setLookAndFeel(nullptr);
     setLookAndFeel(nullptr);
 }
 
 //==============================================================================
 void DelayAudioProcessorEditor::paint (juce::Graphics& g)
 {
+    DELAY_TRACE_ZONE("editor paint");
     
     g.fillAll (Colors::background);
     
@@ -74,23 +97,50 @@ void DelayAudioProcessorEditor::paint (juce::Graphics& g)
     g.setColour(Colors::header);
     g.fillRect(rect);
     
-    auto image = juce::ImageCache::getFromMemory(BinaryData::logo_png,
-                                                 BinaryData::logo_pngSize);
+    auto logoSize = resources->getLogoSize();
+    const auto& logo = resources->getLogo(g.getInternalContext().getPhysicalPixelScaleFactor());
+    g.drawImage(logo, juce::Rectangle<int>(getWidth() / 2 - logoSize.x / 2, 3, logoSize.x, logoSize.y).toFloat());
     
-    int destWidth = image.getWidth() / 2;
-    int destHeight = image.getHeight() / 2;
-    g.drawImage(image,
-                getWidth() / 2 - destWidth / 2, 3, destWidth, destHeight,
-                0, 0, image.getWidth(), image.getHeight());
+    if (outOfMemory)
+    {
+        g.setColour(Colors::warning);
+        g.setFont(resources->getFont(14.0f));
+        g.drawText("Out of memory", rect.withTrimmedLeft(10), juce::Justification::centredLeft);
+    }
+    else if (numCorruptBlocks > 0)
+    {
+        g.setColour(Colors::warning);
+        g.setFont(resources->getFont(14.0f));
+        g.drawText(juce::String(numCorruptBlocks) + (numCorruptBlocks == 1 ? " bad block" : " bad blocks"),
+                   rect.withTrimmedLeft(10), juce::Justification::centredLeft);
+    }
+}
+
+void DelayAudioProcessorEditor::timerCallback()
+{
+    int count = audioProcessor.getNumCorruptBlocks();
+    bool missingMemory = audioProcessor.isOutOfMemory();
+    if (count != numCorruptBlocks || missingMemory != outOfMemory)
+    {
+        numCorruptBlocks = count;
+        outOfMemory = missingMemory;
+        repaint(0, 0, getWidth(), 40);
+    }
     
+    if (audioProcessor.getLastCaptureResult() != captureResult)
+    {
+        updateCaptureButton();
+    }
 }
 
 void DelayAudioProcessorEditor::resized()
 {
     auto bounds = getLocalBounds();
     
-    int y = 50;
-    int height = bounds.getHeight() - 60;
+    waveformDisplay.setBounds(10, 50, bounds.getWidth() - 20, 70);
+    
+    int y = waveformDisplay.getBottom() + 10;
+    int height = bounds.getHeight() - y - 10;
     
     delayGroup.setBounds(10, y, 110, height);
     
@@ -112,9 +162,48 @@ void DelayAudioProcessorEditor::resized()
     
     delayTimeKnob.setTopLeftPosition(20, 20);
     tempoSyncButton.setTopLeftPosition(20, delayTimeKnob.getBottom() + 10);
+    lookaheadButton.setTopLeftPosition(20, tempoSyncButton.getBottom() + 10);
     delayNoteKnob.setTopLeftPosition(delayTimeKnob.getX(), delayTimeKnob.getY());
     
     reverseDelayButton.setBounds(30, 230, 70, 30);
+    
+    captureButton.setTopLeftPosition(bounds.getWidth() - captureButton.getWidth() - 10, 7);
+}
+
+void DelayAudioProcessorEditor::updateCaptureButton()
+{
+    captureResult = audioProcessor.getLastCaptureResult();
+    if (captureResult == HistoryCapture::Result::failed)
+    {
+        captureButton.setButtonText("Failed");
+        captureButton.setColour(juce::TextButton::textColourOffId, Colors::warning);
+    }
+    else
+    {
+        captureButton.setButtonText("Capture");
+        captureButton.removeColour(juce::TextButton::textColourOffId);
+    }
+}
+
+void DelayAudioProcessorEditor::showCaptureMenu()
+{
+    // No file dialog, so the moment worth keeping is still in the history
+    // when the copy starts.
+    juce::PopupMenu menu;
+    bool ready = !audioProcessor.isCapturingHistory();
+    for (int seconds : { 10, 30, 60 })
+    {
+        // The history only reaches that far back after a long delay.
+        bool inHistory = seconds <= audioProcessor.getMaxCaptureSeconds();
+        menu.addItem("Last " + juce::String(seconds) + " s", ready && inHistory, false, [this, seconds]
+        {
+            auto folder = juce::File::getSpecialLocation(juce::File::userMusicDirectory).getChildFile("Delay Captures");
+            folder.createDirectory();
+            auto name = "Capture " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S");
+            audioProcessor.captureHistory(folder.getNonexistentChildFile(name, ".wav"), seconds);
+        });
+    }
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(captureButton));
 }
 
 void DelayAudioProcessorEditor::parameterValueChanged(int, float value)
@@ -13,12 +13,14 @@
 #include "Parameters.h"
 #include "RotaryKnob.h"
 #include "LookAndFeel.h"
+#include "WaveformDisplay.h"
 
 //==============================================================================
 /**
 */
 class DelayAudioProcessorEditor  : public juce::AudioProcessorEditor,
-                                   private juce::AudioProcessorParameter::Listener
+                                   private juce::AudioProcessorParameter::Listener,
+                                   private juce::Timer
 {
 public:
     DelayAudioProcessorEditor (DelayAudioProcessor&);
@@ -32,6 +34,9 @@ private:
     
     DelayAudioProcessor& audioProcessor;
     
+    // Declared before the components, so it outlives them.
+    juce::SharedResourcePointer<UIResources> resources;
+    
     RotaryKnob gainKnob { "Gain", audioProcessor.apvts, gainParamID, true };
     RotaryKnob mixKnob { "Mix", audioProcessor.apvts, mixParamID };
     RotaryKnob delayTimeKnob { "Time", audioProcessor.apvts, delayTimeParamID };
@@ -44,9 +49,9 @@ private:
     RotaryKnob delayNoteKnob { "Note", audioProcessor.apvts, delayNoteParamID };
     
     juce::GroupComponent delayGroup, feedbackGroup, outputGroup;
-
-    MainLookAndFeel mainLF;
     
+    WaveformDisplay waveformDisplay { audioProcessor.getWaveformFeed() };
+
     juce::TextButton reverseDelayButton;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> reverseDelayAttachment;
     
@@ -56,6 +61,29 @@ private:
         audioProcessor.apvts, tempoSyncParamID.getParamID(), tempoSyncButton
     };
     
+    juce::TextButton lookaheadButton;
+    juce::AudioProcessorValueTreeState::ButtonAttachment lookaheadAttachment
+    {
+        audioProcessor.apvts, lookaheadParamID.getParamID(), lookaheadButton
+    };
+    
+    // Saves the last seconds of the delay history into the capture folder.
+    // Turns into a warning when the file could not be written, until the
+    // next capture starts.
+    juce::TextButton captureButton;
+    HistoryCapture::Result captureResult = HistoryCapture::Result::none;
+    void showCaptureMenu();
+    void updateCaptureButton();
+    
+    // Shows in the header how often the processor had to clean up samples
+    // that were not finite, once it has happened at all.
+    int numCorruptBlocks = 0;
+    
+    // Shows instead when the processor could not get the memory for its
+    // histories and passes the input through.
+    bool outOfMemory = false;
+    void timerCallback() override;
+    
     void parameterValueChanged(int, float) override;
     void parameterGestureChanged(int, bool) override { }
     void updateDelayKnobs(bool tempoSyncActive);
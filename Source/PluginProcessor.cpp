@@ -18,17 +18,36 @@ DelayAudioProcessor::DelayAudioProcessor()
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
+                       .withOutput ("Dry", juce::AudioChannelSet::stereo(), false)
+                       .withOutput ("Forward", juce::AudioChannelSet::stereo(), false)
+                       .withOutput ("Reverse", juce::AudioChannelSet::stereo(), false)
                      #endif
                        ),
                         params(apvts)
 #endif
 {
-    lowCutFilter.setType(juce::dsp::StateVariableTPTFilterType::highpass);
-    highCutFilter.setType(juce::dsp::StateVariableTPTFilterType::lowpass);
+   #if DELAY_TRACING
+    auto tracePath = juce::SystemStats::getEnvironmentVariable("DELAY_TRACE_FILE", {});
+    if (tracePath.isNotEmpty())
+    {
+        traceFile = juce::File::getCurrentWorkingDirectory().getChildFile(tracePath);
+        Trace::start();
+    }
+   #endif
 }
 
 DelayAudioProcessor::~DelayAudioProcessor()
 {
+    // The worker calls into the engines, which are destroyed before it.
+    pipeline.release();
+    
+   #if DELAY_TRACING
+    if (traceFile != juce::File())
+    {
+        Trace::stop();
+        Trace::writeJson(traceFile);
+    }
+   #endif
 }
 
 //==============================================================================
@@ -64,9 +83,47 @@ bool DelayAudioProcessor::isMidiEffect() const
    #endif
 }
 
+juce::AudioProcessorParameter* DelayAudioProcessor::getBypassParameter() const
+{
+    return params.bypassParam;
+}
+
 double DelayAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    // Hosts stop processing and end offline renders once the tail is over,
+    // so this errs on the long side. Each repeat comes one delay after the
+    // last, or up to two segments plus the fade and the spectral latency in
+    // reverse, and the repeats fall below -60 dB after ln(0.001) / ln(feedback)
+    // of them. At 100% feedback they never do.
+    float feedback = apvts.getRawParameterValue(feedbackParamID.getParamID())->load() * 0.01f;
+    if (feedback >= 1.0f)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    
+    double sampleRate = getSampleRate() > 0.0 ? getSampleRate() : 44100.0;
+    double period = double(tailDelayTime.load(std::memory_order_relaxed)) / 1000.0;
+    if (params.reverseDelayParam->get())
+    {
+        period = 2.0 * period + double(reverseFadeTime) / 1000.0;
+        if (apvts.getRawParameterValue(spectralParamID.getParamID())->load() >= 0.5f && engineSampleRate > 0.0)
+        {
+            period += double(spectralReverse.getLatency()) / engineSampleRate;
+        }
+    }
+    
+    double numRepeats = 1.0;
+    if (feedback > 0.0f)
+    {
+        numRepeats += std::log(0.001) / std::log(double(feedback));
+    }
+    double tail = period * numRepeats;
+    
+    if (apvts.getRawParameterValue(reverbParamID.getParamID())->load() >= 0.5f)
+    {
+        tail += double(reverseReverb.getLatency() + reverseReverb.getImpulseLength()) / sampleRate;
+    }
+    return tail;
 }
 
 int DelayAudioProcessor::getNumPrograms()
@@ -96,53 +153,327 @@ void DelayAudioProcessor::changeProgramName (int index, const juce::String& newN
 //==============================================================================
 void DelayAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
-    params.prepareToPlay(sampleRate);
-    params.reset();
+    DELAY_TRACE_ZONE("prepareToPlay");
+    pipeline.release();
     
-    juce::dsp::ProcessSpec spec;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = juce::uint32(samplesPerBlock);
-    spec.numChannels = 2;
+    // Everything from here on runs at the engine rate, apart from the dry
+    // delay and the resamplers.
+    int numLanes = getMainBusNumOutputChannels() > 2 ? getMainBusNumOutputChannels() / 2 : 0;
+    decimation = isDecimatedWet() && numLanes == 0 ? chooseDecimation(sampleRate) : 1;
+    engineSampleRate = sampleRate / decimation;
+    resamplerLatency = HalfBandResampler::getLatency(decimation, sampleRate);
+    decimator.prepare(HalfBandResampler::Direction::down, decimation, sampleRate, samplesPerBlock);
+    for (auto& interpolator : interpolators)
+    {
+        interpolator.prepare(HalfBandResampler::Direction::up, decimation, sampleRate, samplesPerBlock);
+    }
+    reduced.setSize(2 * numStems, samplesPerBlock / decimation + 1);
+    reduced.clear();
+    
+    params.prepareToPlay(engineSampleRate);
+    params.reset();
     
-    delayLine.prepare(spec);
+    kernels = &VectorKernels::get(VectorKernels::select(forcedKernels));
+    auto storage = isCompactStorage() ? DelayBuffer::Storage::compact : DelayBuffer::Storage::full;
     
-    double numSamples = Parameters::maxDelayTime / 1000.0 * sampleRate;
+    double numSamples = Parameters::maxDelayTime / 1000.0 * engineSampleRate;
     int maxDelayInSamples = int(std::ceil(numSamples));
-    delayLine.setMaximumDelayInSamples(maxDelayInSamples);
-    delayLine.reset();
+    
+    historyCapture.cancel();
+    waveformFeed.prepare(engineSampleRate);
+    
+    // One extra sample because the feedback of each chunk is shifted by one.
+    scratch.setSize(numScratchChannels, samplesPerBlock + 1);
+    scratch.clear();
     
     feedbackL = 0.0f;
     feedbackR = 0.0f;
     
-    reverseBuffer.setSize(2, maxDelayInSamples);
-    reverseBuffer.clear();
-    reverseBufferIndex = 0;
+    reverseFadeLength = std::max(1, int(reverseFadeTime / 1000.0 * engineSampleRate));
+    historyTime.store(juce::jlimit(minHistoryTime, Parameters::maxDelayTime, params.getTargetDelayTime()));
+    requestedHistoryTime = historyTime.load();
+    bool allocated = delayLine.prepare(getWetHistoryLength(historyTime.load()), *kernels, storage);
+    reverseHead = {};
+    fadingHead = {};
+    reversePhase = 0.0f;
+    reverseSegmentLength = 0.0f;
+    
+    // Onset mode cuts no segment shorter than minSegmentTime and a head
+    // waits for less than two delay times, which bounds the queue while the
+    // delay time holds still. A head that finds it full is dropped.
+    headQueue.resize(size_t(2.0f * Parameters::maxDelayTime / minSegmentTime) + 4);
+    queueStart = 0;
+    queueLength = 0;
     
+    onsetDetector.prepare(engineSampleRate);
     
-    lowCutFilter.prepare(spec);
-    lowCutFilter.reset();
+    int maxSpectralSegment = int(std::ceil(maxSpectralSegmentTime / 1000.0 * engineSampleRate));
+    spectralReverse.prepare(std::min(maxDelayInSamples, maxSpectralSegment), SpectralReverse::Options());
+    prevSpectralActive = false;
     
-    highCutFilter.prepare(spec);
-    highCutFilter.reset();
+    allocated = dryDelayLine.prepare(getDryHistoryLength(historyTime.load()), *kernels, storage) && allocated;
+    
+    int maxLaneDelay = int(std::ceil(maxLaneDelayTime / 1000.0 * sampleRate));
+    for (int lane = 0; lane < MultiLaneDelay::maxLanes; ++lane)
+    {
+        laneSettings[size_t(lane)] = getLaneSettings(lane);
+    }
+    allocated = multiLane.prepare(numLanes, maxLaneDelay, samplesPerBlock, *kernels) && allocated;
+    
+    // The pool has nothing to give when the system is out of memory. Rather
+    // than failing the host, the plugin then passes its input through.
+    outOfMemory.store(!allocated, std::memory_order_relaxed);
+    
+    // The reverb runs at the host rate, next to the dry signal, and not at
+    // all with lanes.
+    reverseReverb.release();
+    if (numLanes == 0)
+    {
+        juce::AudioBuffer<float> impulse;
+        if (getReverbImpulse() != juce::File())
+        {
+            impulse = ReverseReverb::loadImpulse(getReverbImpulse(), sampleRate, maxReverbSeconds);
+        }
+        if (impulse.getNumSamples() == 0)
+        {
+            impulse = ReverseReverb::createImpulse(sampleRate, getReverbLength());
+        }
+        ReverseReverb::Options reverbOptions;
+        reverbOptions.useWorker = isReverbWorker();
+        reverseReverb.prepare(impulse, reverbOptions);
+    }
+    reverbBuffer.setSize(numReverbChannels, samplesPerBlock);
+    reverbBuffer.clear();
+    
+    feedbackFilter.prepare(engineSampleRate, *kernels);
+    dcBlocker.prepare(engineSampleRate);
+    recoveryGain = 1.0f;
+    recoveryStep = 1.0f / std::max(1.0f, float(recoveryFadeTime / 1000.0 * engineSampleRate));
+    filtersRunning = false;
     
     tempo.reset();
+    
+    params.update();
+    reverseActive = params.reverseDelayParam->get();
+    prevReverseActive = reverseActive;
+    engineMix = reverseActive ? 1.0f : 0.0f;
+    reverbMix = params.reverb && reverseReverb.getImpulseLength() > 0 ? 1.0f : 0.0f;
+    enginesCleared = false;
+    
+    bypassed = params.bypassParam->get();
+    bypassMix = bypassed ? 1.0f : 0.0f;
+    tailPeak = 0.0f;
+    tailSilence = 0;
+    tailIdle = bypassed;
+    
+    flushOnTransport = isFlushOnTransport();
+    wasTransportPlaying = false;
+    nextTransportTime = -1;
+    lastDryGain = (1.0f - params.mix) * (1.0f - bypassMix) * params.gain + bypassMix;
+    lastStemGain = params.gain;
+    lastReverbGain = params.mix * params.gain;
+    
+    if (isPipelined())
+    {
+        int numChannels = std::max(getTotalNumInputChannels(), getTotalNumOutputChannels());
+        pipeline.prepare(getTotalNumInputChannels(), numChannels, samplesPerBlock, sampleRate,
+                         [this](juce::AudioBuffer<float>& buffer, const Pipeline::Position& position, bool hostBypass)
+                         {
+                             processEngines(buffer, position, hostBypass);
+                         });
+    }
+    
+    float delayTime = params.tempoSync ? float(tempo.getMillisecondsForNoteLength(params.delayNote))
+                                       : params.getTargetDelayTime();
+    
+    delayTime = std::min(delayTime, historyTime.load());
+    
+    // The spectral ring is otherwise only allocated once the engine is used.
+    if (params.spectral)
+    {
+        spectralReverse.reserve(int(delayTime / 1000.0f * engineSampleRate));
+    }
+    
+    tailDelayTime.store(delayTime, std::memory_order_relaxed);
+    updateLatency(delayTime);
+}
+
+int DelayAudioProcessor::getWetHistoryLength(float delayTime) const noexcept
+{
+    // Both engines read the same history. A reverse segment is played while
+    // the next one is captured, and a fading head reads a little further
+    // back still, so the reverse engine sets the size.
+    int delayInSamples = int(std::ceil(delayTime / 1000.0 * engineSampleRate));
+    return 2 * delayInSamples + 2 * reverseFadeLength + 4;
+}
+
+int DelayAudioProcessor::getDryHistoryLength(float delayTime) const noexcept
+{
+    // Lookahead delays the dry signal by up to two segments plus the latency
+    // of the spectral engine, and by the resamplers when decimated. It stays
+    // at the full rate, and covers the same delay time as the wet history,
+    // so a latency change never has to wait for it.
+    int delayInSamples = int(std::ceil(delayTime / 1000.0 * engineSampleRate * decimation));
+    return 2 * delayInSamples + spectralReverse.getLatency() * decimation + resamplerLatency;
+}
+
+void DelayAudioProcessor::growHistories(float delayTime, int numSamples)
+{
+    if (delayTime > requestedHistoryTime)
+    {
+        // At least twice as long each time, so a delay on its way up only
+        // grows them a few times.
+        requestedHistoryTime = std::min(std::max(delayTime, 2.0f * requestedHistoryTime), Parameters::maxDelayTime);
+        
+        // Offline they grow right here, so a render never depends on the
+        // timing of the background thread.
+        if (isNonRealtime())
+        {
+            delayLine.reserve(getWetHistoryLength(requestedHistoryTime));
+            dryDelayLine.reserve(getDryHistoryLength(requestedHistoryTime));
+        }
+    }
+    
+    int wetLength = getWetHistoryLength(requestedHistoryTime);
+    int dryLength = getDryHistoryLength(requestedHistoryTime);
+    if (delayLine.getMaxDelay() < wetLength || dryDelayLine.getMaxDelay() < dryLength)
+    {
+        delayLine.grow(wetLength, numSamples);
+        dryDelayLine.grow(dryLength, numSamples);
+        if (delayLine.getMaxDelay() >= wetLength && dryDelayLine.getMaxDelay() >= dryLength)
+        {
+            historyTime.store(requestedHistoryTime, std::memory_order_relaxed);
+        }
+    }
 }
 
 void DelayAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    pipeline.release();
+}
+
+void DelayAudioProcessor::updateLatency(float delayTime)
+{
+    int latency = 0;
+    
+    if (params.lookahead && params.reverb && reverseReverb.getImpulseLength() > 0)
+    {
+        // The reversed impulse peaks at its last sample. The reverb runs at
+        // the host rate, so the resamplers added below are already part of
+        // the wait.
+        latency = reverseReverb.getLatency() + reverseReverb.getImpulseLength() - 1;
+        latency = std::max(0, latency - resamplerLatency);
+    }
+    else if (params.lookahead && reverseActive && multiLane.getNumLanes() == 0)
+    {
+        // A segment can only be played backwards once it has been captured
+        // completely. Its first sample, where a transient sits and the swell
+        // peaks, is the last one played from it, two segment lengths minus
+        // one sample after it went in, and segments cut short by onsets wait
+        // to keep it there. The length is taken at the engine rate the way
+        // processReverseSample takes it, fraction included, and only the
+        // total is rounded to host samples. Reporting exactly that lets the
+        // host line the peak up with the source transient.
+        float segmentLength = std::max(1.0f, delayTime / 1000.0f * float(engineSampleRate));
+        float engineLatency = 2.0f * segmentLength - 1.0f;
+        
+        if (params.spectral)
+        {
+            engineLatency += float(spectralReverse.getLatency());
+        }
+        latency = int(std::lround(engineLatency * float(decimation)));
+    }
+    
+    // Going down to the engine rate and back up delays the wet signal, so the
+    // dry signal has to wait for it.
+    latency += resamplerLatency;
+    
+    // The dry signal only lines up with the engines. The pipeline delays
+    // both by the same amount.
+    dryDelay = float(latency);
+    latency += pipeline.getLatency();
+    
+    if (latency != getLatencySamples())
+    {
+        setLatencySamples(latency);
+    }
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
 bool DelayAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 {
-    return layouts.getMainOutputChannelSet() == juce::AudioChannelSet::stereo();
+    auto mainOutput = layouts.getMainOutputChannelSet();
+    bool lanes = mainOutput != juce::AudioChannelSet::stereo();
+    
+    // A wider main bus runs one delay lane per channel pair, with the same
+    // channels in and out.
+    if (lanes)
+    {
+        int numChannels = mainOutput.size();
+        if (numChannels < 4 || numChannels > 2 * MultiLaneDelay::maxLanes || numChannels % 2 != 0
+            || layouts.getMainInputChannelSet() != mainOutput)
+        {
+            return false;
+        }
+    }
+    
+    // The stem outputs are either off or stereo, and always off with lanes.
+    for (int bus = 1; bus < layouts.outputBuses.size(); ++bus)
+    {
+        auto set = layouts.getChannelSet(false, bus);
+        if (!set.isDisabled() && (lanes || set != juce::AudioChannelSet::stereo()))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 #endif
 
 void DelayAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[maybe_unused]] juce::MidiBuffer& midiMessages)
 {
+    processHostBlock(buffer, false);
+}
+
+void DelayAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer, [[maybe_unused]] juce::MidiBuffer& midiMessages)
+{
+    processHostBlock(buffer, true);
+}
+
+void DelayAudioProcessor::processHostBlock(juce::AudioBuffer<float>& buffer, bool hostBypass)
+{
+    DELAY_TRACE_ZONE("processBlock");
+    
+    if (outOfMemory.load(std::memory_order_relaxed))
+    {
+        for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+            buffer.clear (i, 0, buffer.getNumSamples());
+        return;
+    }
+    
+    // The play head is only valid during the callback, so the pipeline
+    // carries a copy of the position along with the block.
+    Pipeline::Position position;
+    if (auto* playHead = getPlayHead())
+    {
+        position = playHead->getPosition();
+    }
+    
+    if (pipeline.isRunning())
+    {
+        pipeline.process(buffer, position, hostBypass);
+    }
+    else
+    {
+        processEngines(buffer, position, hostBypass);
+    }
+}
+
+void DelayAudioProcessor::processEngines(juce::AudioBuffer<float>& buffer, const Pipeline::Position& position, bool hostBypass)
+{
+    DELAY_TRACE_ZONE("engines");
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -150,141 +481,1373 @@ void DelayAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, [[mayb
  
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
+    
+    int numPairs = std::max(1, multiLane.getNumLanes());
+    for (int pair = 0; pair < numPairs; ++pair)
+    {
+        checkInput(buffer.getWritePointer(2 * pair), buffer.getWritePointer(2 * pair + 1), buffer.getNumSamples());
+    }
 
     params.update();
-    tempo.update(getPlayHead());
+    tempo.update(position);
+    
+    if (flushOnTransport && transportJumped(position, buffer.getNumSamples()))
+    {
+        DELAY_TRACE_ZONE("transport flush");
+        clearEngines();
+        reverseReverb.reset();
+    }
     float syncedTime = float(tempo.getMillisecondsForNoteLength(params.delayNote));
     if (syncedTime > Parameters::maxDelayTime)
     {
         syncedTime = Parameters::maxDelayTime;
     }
     
+    // The lanes have histories of their own.
+    if (multiLane.getNumLanes() == 0)
+    {
+        growHistories(params.tempoSync ? syncedTime : params.getTargetDelayTime(), buffer.getNumSamples());
+    }
+    float maxTime = historyTime.load(std::memory_order_relaxed);
+    params.limitDelayTime(maxTime);
+    syncedTime = std::min(syncedTime, maxTime);
+    
     reverseActive = params.reverseDelayParam->get();
+    updateLatency(params.tempoSync ? syncedTime : params.getTargetDelayTime());
+    tailDelayTime.store(params.tempoSync ? syncedTime : std::max(params.delayTime, params.getTargetDelayTime()),
+                        std::memory_order_relaxed);
+    
+    // The wrappers call processBlockBypassed when the host bypasses without
+    // going through the parameter.
+    bypassed = hostBypass || params.bypassParam->get();
+    
+    if (multiLane.getNumLanes() > 0)
+    {
+        processLanes(buffer, syncedTime);
+        return;
+    }
+    
+    BlockContext context;
+    context.syncedTime = syncedTime;
+    context.sampleRate = float(engineSampleRate);
+    context.minSegmentLength = static_cast<int>(minSegmentTime / 1000.0f * context.sampleRate);
     
-    float sampleRate = float(getSampleRate());
+    for (int stem = 0; stem < numStems; ++stem)
+    {
+        auto* bus = getBus(false, stem + 1);
+        if (bus != nullptr && bus->isEnabled())
+        {
+            auto stemBuffer = getBusBuffer(buffer, false, stem + 1);
+            context.stemLeft[stem] = stemBuffer.getWritePointer(0);
+            context.stemRight[stem] = stemBuffer.getWritePointer(1);
+            context.stemsActive = true;
+        }
+    }
     
+    bool reverbActive = params.reverb && reverseReverb.getImpulseLength() > 0;
+    if (reverbActive || reverbMix > 0.0f)
+    {
+        processReverb(buffer, context, reverbActive);
+        return;
+    }
     
+    if (decimation > 1)
+    {
+        processDecimated(buffer, context);
+    }
+    else
+    {
+        processCore(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples(), context);
+        
+        // Where a fade to the reverb picks up the dry signal.
+        lastDryGain = (1.0f - params.mix) * (1.0f - bypassMix) * params.gain + bypassMix;
+        lastStemGain = params.gain;
+    }
+    lastReverbGain = params.mix * params.gain;
+}
+
+void DelayAudioProcessor::processDecimated(juce::AudioBuffer<float>& buffer, BlockContext& hostContext) noexcept
+{
+    DELAY_TRACE_ZONE("decimated wet");
     float* channelDataL = buffer.getWritePointer(0);
     float* channelDataR = buffer.getWritePointer(1);
+    int numSamples = buffer.getNumSamples();
     
-    int delayBufferSize = reverseBuffer.getNumSamples();
+    // The engines get the input at their own rate, with their stems in the
+    // reduced buffer. The dry stem is written here at the full rate.
+    BlockContext context = hostContext;
+    context.dryInOutput = false;
+    context.stemLeft[dryStem] = nullptr;
+    context.stemRight[dryStem] = nullptr;
+    for (int stem = forwardStem; stem < numStems; ++stem)
+    {
+        if (hostContext.stemLeft[stem] != nullptr)
+        {
+            context.stemLeft[stem] = reduced.getWritePointer(2 * stem);
+            context.stemRight[stem] = reduced.getWritePointer(2 * stem + 1);
+        }
+    }
     
-    for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+    float* wetL = reduced.getWritePointer(0);
+    float* wetR = reduced.getWritePointer(1);
+    int numReduced = decimator.decimate(channelDataL, channelDataR, numSamples, wetL, wetR);
+    processCore(wetL, wetR, numReduced, context);
+    
+    if (hostContext.dryInOutput)
     {
-        params.smoothen();
-        
-        float delayTime = params.tempoSync ? syncedTime : params.delayTime;
-        float delayInSamples = delayTime / 1000.0f * sampleRate;
-        delayLine.setDelay(delayInSamples);
-        
-        lowCutFilter.setCutoffFrequency(params.lowCut);
-        highCutFilter.setCutoffFrequency(params.highCut);
-        
-        float dryL = channelDataL[sample];
-        float dryR = channelDataR[sample];
-        
-        float mono = (dryL + dryR) * 0.5f;
+        // Lines the dry signal up with the wet one, which the resamplers
+        // delay even without lookahead.
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dryDelayLine.pushSample(channelDataL[i], channelDataR[i]);
+            dryDelayLine.popSample(dryDelay, channelDataL[i], channelDataR[i]);
+        }
         
-        if (reverseActive)
+        // The gains the kernels would have applied to the dry signal, which
+        // the engines have reached by the end of the block.
+        float* ramp = scratch.getWritePointer(gainRamp);
+        if (float* stemLeft = hostContext.stemLeft[dryStem])
         {
-            
-            if (!prevReverseActive)
-            {
-                // Set the reverse read pointer to "delayInSamples" behind the current write pointer.
-                reverseBlockSampleCount = 0;
-                reverseReadPointer = (reverseBufferIndex + delayBufferSize - static_cast<int>(delayInSamples)) % delayBufferSize;
-                prevReverseActive = true;
-            }
-            reverseBuffer.setSample(0, reverseBufferIndex, mono*params.panL + feedbackR);
-            reverseBuffer.setSample(1, reverseBufferIndex, mono*params.panR + feedbackL);
-            
-            reverseBufferIndex = (reverseBufferIndex + 1) % delayBufferSize;
-            
-            
-            int currentReverseIndex = (reverseBlockStart + static_cast<int>(delayInSamples) - 1 - reverseBlockSampleCount) % delayBufferSize;
-            
-                    
-            float wetL = reverseBuffer.getSample(0, currentReverseIndex);
-            float wetR = reverseBuffer.getSample(1, currentReverseIndex);
-            
-            reverseBlockSampleCount++;
-            
-            if (reverseBlockSampleCount >= static_cast<int>(delayInSamples))
-            {
-                reverseBlockSampleCount = 0;
-                reverseBlockStart = (reverseBufferIndex + delayBufferSize - static_cast<int>(delayInSamples)) % delayBufferSize;
-            }
-            
-            feedbackL = wetL * params.feedback;
-            feedbackL = lowCutFilter.processSample(0, feedbackL);
-            feedbackL = highCutFilter.processSample(0, feedbackL);
-            
-            feedbackR = wetR * params.feedback;
-            feedbackR = lowCutFilter.processSample(1, feedbackR);
-            feedbackR = highCutFilter.processSample(1, feedbackR);
-            
-            float mixL = dryL * (1.0f - params.mix) + wetL * params.mix;
-            float mixR = dryR * (1.0f - params.mix) + wetR * params.mix;
-            
-            channelDataL[sample] = mixL * params.gain;
-            channelDataR[sample] = mixR * params.gain;
-            
-            // channelDataL[sample] = dryL * (1.0f - params.mix) + wetL * params.mix;
-            // channelDataR[sample] = dryR * (1.0f - params.mix) + wetR * params.mix;
-              
-            
+            fillRamp(ramp, lastStemGain, params.gain, numSamples);
+            juce::FloatVectorOperations::multiply(stemLeft, channelDataL, ramp, numSamples);
+            juce::FloatVectorOperations::multiply(hostContext.stemRight[dryStem], channelDataR, ramp, numSamples);
         }
-        else
+        lastStemGain = params.gain;
+        
+        float dryGain = (1.0f - params.mix) * (1.0f - bypassMix) * params.gain + bypassMix;
+        fillRamp(ramp, lastDryGain, dryGain, numSamples);
+        juce::FloatVectorOperations::multiply(channelDataL, ramp, numSamples);
+        juce::FloatVectorOperations::multiply(channelDataR, ramp, numSamples);
+        lastDryGain = dryGain;
+    }
+    else
+    {
+        juce::FloatVectorOperations::clear(channelDataL, numSamples);
+        juce::FloatVectorOperations::clear(channelDataR, numSamples);
+    }
+    
+    float* upL = scratch.getWritePointer(wetLeft);
+    float* upR = scratch.getWritePointer(wetRight);
+    interpolators[dryStem].interpolate(wetL, wetR, numReduced, upL, upR, numSamples);
+    juce::FloatVectorOperations::add(channelDataL, upL, numSamples);
+    juce::FloatVectorOperations::add(channelDataR, upR, numSamples);
+    
+    for (int stem = forwardStem; stem < numStems; ++stem)
+    {
+        if (float* stemLeft = hostContext.stemLeft[stem])
         {
-            prevReverseActive = false;
-            
-            delayLine.pushSample(0, mono*params.panL + feedbackR);
-            delayLine.pushSample(1, mono*params.panR + feedbackL);
-            
-            float wetL = delayLine.popSample(0);
-            float wetR = delayLine.popSample(1);
-            
-            feedbackL = wetL * params.feedback;
-            feedbackL = lowCutFilter.processSample(0, feedbackL);
-            feedbackL = highCutFilter.processSample(0, feedbackL);
-            
-            feedbackR = wetR * params.feedback;
-            feedbackR = lowCutFilter.processSample(1, feedbackR);
-            feedbackR = highCutFilter.processSample(1, feedbackR);
-            
-            float mixL = dryL * (1.0f - params.mix) + wetL * params.mix;
-            float mixR = dryL * (1.0f - params.mix) + wetR * params.mix;
-            
-            channelDataL[sample] = mixL * params.gain;
-            channelDataR[sample] = mixR * params.gain;
+            interpolators[size_t(stem)].interpolate(context.stemLeft[stem], context.stemRight[stem], numReduced,
+                                                    stemLeft, hostContext.stemRight[stem], numSamples);
         }
-       
     }
 }
 
-//==============================================================================
-bool DelayAudioProcessor::hasEditor() const
-{
-    return true; // (change this to false if you choose to not supply an editor)
-}
-
-juce::AudioProcessorEditor* DelayAudioProcessor::createEditor()
+void DelayAudioProcessor::fillRamp(float* ramp, float start, float end, int numSamples) noexcept
 {
-    return new DelayAudioProcessorEditor (*this);
+    // Close enough for the smoothed parameters, which change little within
+    // a block.
+    float step = (end - start) / float(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        ramp[i] = start + step * float(i + 1);
+    }
 }
 
-//==============================================================================
-void DelayAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+void DelayAudioProcessor::processReverb(juce::AudioBuffer<float>& buffer, BlockContext& hostContext, bool reverbActive) noexcept
 {
-    copyXmlToBinary(*apvts.copyState().createXml(), destData);
+    DELAY_TRACE_ZONE("reverse reverb");
+    float* channelDataL = buffer.getWritePointer(0);
+    float* channelDataR = buffer.getWritePointer(1);
+    int numSamples = buffer.getNumSamples();
+    float* reverbL = reverbBuffer.getWritePointer(reverbLeft);
+    float* reverbR = reverbBuffer.getWritePointer(reverbRight);
+    float* dryL = reverbBuffer.getWritePointer(reverbDryLeft);
+    float* dryR = reverbBuffer.getWritePointer(reverbDryRight);
+    float* fade = reverbBuffer.getWritePointer(reverbFade);
+    float* ramp = reverbBuffer.getWritePointer(reverbRamp);
+    
+    // The engines work on the buffer in place, so the reverb and the dry
+    // signal get copies of the input.
+    juce::FloatVectorOperations::copy(reverbL, channelDataL, numSamples);
+    juce::FloatVectorOperations::copy(reverbR, channelDataR, numSamples);
+    juce::FloatVectorOperations::copy(dryL, channelDataL, numSamples);
+    juce::FloatVectorOperations::copy(dryR, channelDataR, numSamples);
+    
+    float fadeLength = params.reverseFade / 1000.0f * float(getSampleRate());
+    float fadeStep = fadeLength > 1.0f ? 1.0f / fadeLength : 1.0f;
+    float target = reverbActive ? 1.0f : 0.0f;
+    bool enginesAudible = reverbMix < 1.0f;
+    for (int i = 0; i < numSamples; ++i)
+    {
+        reverbMix = reverbMix < target ? std::min(target, reverbMix + fadeStep)
+                                       : std::max(target, reverbMix - fadeStep);
+        fade[i] = reverbMix;
+    }
+    enginesAudible = enginesAudible || reverbMix < 1.0f;
+    
+    float startBypass = bypassMix;
+    if (enginesAudible)
+    {
+        // Only the wet signal of the engines, faded against the reverb. The
+        // dry signal below is shared by both.
+        BlockContext context = hostContext;
+        context.dryInOutput = false;
+        context.stemLeft[dryStem] = nullptr;
+        context.stemRight[dryStem] = nullptr;
+        if (decimation > 1)
+        {
+            processDecimated(buffer, context);
+        }
+        else
+        {
+            processCore(channelDataL, channelDataR, numSamples, context);
+        }
+        
+        for (int i = 0; i < numSamples; ++i)
+        {
+            channelDataL[i] *= 1.0f - fade[i];
+            channelDataR[i] *= 1.0f - fade[i];
+        }
+        enginesCleared = false;
+    }
+    else
+    {
+        // The engines start over from silence when the reverb is switched
+        // off. Meanwhile the parameters and the bypass fade move on as if
+        // they were running.
+        if (!enginesCleared)
+        {
+            clearEngines();
+            enginesCleared = true;
+        }
+        juce::FloatVectorOperations::clear(channelDataL, numSamples);
+        juce::FloatVectorOperations::clear(channelDataR, numSamples);
+        
+        int numEngineSamples = std::max(1, numSamples / decimation);
+        params.renderOutputRamps(scratch.getWritePointer(gainRamp), scratch.getWritePointer(mixRamp), numEngineSamples);
+        
+        float bypassStep = float(numSamples) / std::max(1.0f, bypassFadeTime / 1000.0f * float(getSampleRate()));
+        bypassMix = bypassed ? std::min(1.0f, bypassMix + bypassStep) : std::max(0.0f, bypassMix - bypassStep);
+        
+        historyCapture.process(delayLine, numEngineSamples);
+        waveformFeed.push(nullptr, nullptr, numEngineSamples, -1, -1.0f, -1.0f);
+    }
+    
+    // The dry delay lines the signal up with the peak of the swell under
+    // lookahead, and with the resamplers when decimated.
+    if (dryDelay > 0.0f)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dryDelayLine.pushSample(dryL[i], dryR[i]);
+            dryDelayLine.popSample(dryDelay, dryL[i], dryR[i]);
+        }
+    }
+    
+    if (float* stemLeft = hostContext.stemLeft[dryStem])
+    {
+        fillRamp(ramp, lastStemGain, params.gain, numSamples);
+        juce::FloatVectorOperations::multiply(stemLeft, dryL, ramp, numSamples);
+        juce::FloatVectorOperations::multiply(hostContext.stemRight[dryStem], dryR, ramp, numSamples);
+    }
+    lastStemGain = params.gain;
+    
+    float dryGain = (1.0f - params.mix) * (1.0f - bypassMix) * params.gain + bypassMix;
+    fillRamp(ramp, lastDryGain, dryGain, numSamples);
+    juce::FloatVectorOperations::addWithMultiply(channelDataL, dryL, ramp, numSamples);
+    juce::FloatVectorOperations::addWithMultiply(channelDataR, dryR, ramp, numSamples);
+    lastDryGain = dryGain;
+    
+    // Bypassing fades the input out of the reverb, and the swells already
+    // on their way play out.
+    fillRamp(ramp, 1.0f - startBypass, 1.0f - bypassMix, numSamples);
+    juce::FloatVectorOperations::multiply(reverbL, ramp, numSamples);
+    juce::FloatVectorOperations::multiply(reverbR, ramp, numSamples);
+    reverseReverb.process(reverbL, reverbR, reverbL, reverbR, numSamples);
+    
+    float reverbGain = params.mix * params.gain;
+    fillRamp(ramp, lastReverbGain, reverbGain, numSamples);
+    juce::FloatVectorOperations::multiply(ramp, fade, numSamples);
+    juce::FloatVectorOperations::addWithMultiply(channelDataL, reverbL, ramp, numSamples);
+    juce::FloatVectorOperations::addWithMultiply(channelDataR, reverbR, ramp, numSamples);
+    lastReverbGain = reverbGain;
+    
+    // Switched off and faded out, so the next time starts from silence.
+    if (!reverbActive && reverbMix <= 0.0f)
+    {
+        reverseReverb.reset();
+    }
 }
 
-void DelayAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+void DelayAudioProcessor::processLanes(juce::AudioBuffer<float>& buffer, float syncedTime) noexcept
 {
-    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
-    if (xml.get() != nullptr && xml->hasTagName(apvts.state.getType()))
+    DELAY_TRACE_ZONE("lanes");
+    int numSamples = buffer.getNumSamples();
+    
+    // The smoothers move on by the whole block and the lanes ramp to where
+    // they end up, which is close enough for the smoothed parameters.
+    params.skip(numSamples);
+    
+    // Bypassing stops the input from reaching the delay and lets the echoes
+    // in flight play out over the unity dry signal, like the stereo engine.
+    float delayTime = params.tempoSync ? syncedTime : params.delayTime;
+    for (int index = 0; index < multiLane.getNumLanes(); ++index)
     {
-        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        const auto& settings = laneSettings[size_t(index)];
+        float laneTime = std::min(delayTime * settings.timeScale, maxLaneDelayTime);
+        
+        MultiLaneDelay::Lane lane;
+        lane.delayInSamples = laneTime / 1000.0f * float(getSampleRate());
+        lane.feedback = std::min(params.feedback * settings.feedbackScale, 1.0f);
+        if (!bypassed)
+        {
+            panningEqualPower(juce::jlimit(-1.0f, 1.0f, params.getStereo() + settings.stereo), lane.panL, lane.panR);
+        }
+        else
+        {
+            lane.panL = 0.0f;
+            lane.panR = 0.0f;
+        }
+        lane.dryGain = bypassed ? 1.0f : (1.0f - params.mix) * params.gain;
+        lane.wetGain = params.mix * params.gain;
+        multiLane.setLane(index, lane);
+    }
+    multiLane.process(buffer.getArrayOfWritePointers(), numSamples);
+    
+    // The stereo history stays empty, so a capture finishes with silence.
+    historyCapture.process(delayLine, numSamples);
+    waveformFeed.push(nullptr, nullptr, numSamples, -1, -1.0f, -1.0f);
+}
+
+void DelayAudioProcessor::processCore(float* channelDataL, float* channelDataR, int numSamples, BlockContext& context) noexcept
+{
+    float sampleRate = context.sampleRate;
+    float syncedTime = context.syncedTime;
+    bypassFadeStep = 1.0f / std::max(1.0f, bypassFadeTime / 1000.0f * sampleRate);
+    
+    if (bypassed && tailIdle)
+    {
+        processIdle(channelDataL, channelDataR, numSamples, context.dryInOutput);
+        
+        // The other stems are silent, and the aux channels were cleared above.
+        if (float* stemLeft = context.stemLeft[dryStem])
+        {
+            juce::FloatVectorOperations::copyWithMultiply(stemLeft, channelDataL, params.gain, numSamples);
+            juce::FloatVectorOperations::copyWithMultiply(context.stemRight[dryStem], channelDataR, params.gain, numSamples);
+        }
+        historyCapture.process(delayLine, numSamples);
+        waveformFeed.push(nullptr, nullptr, numSamples, -1, -1.0f, -1.0f);
+        return;
+    }
+    tailIdle = false;
+    
+    float fadeLength = params.reverseFade / 1000.0f * sampleRate;
+    engineFadeStep = fadeLength > 1.0f ? 1.0f / fadeLength : 1.0f;
+    
+    if (reverseActive && !prevReverseActive && engineMix <= 0.0f)
+    {
+        // Nothing has been captured yet, so the first segment is silent.
+        float delayInSamples = (params.tempoSync ? syncedTime : params.delayTime) / 1000.0f * sampleRate;
+        reverseHead = {};
+        fadingHead = {};
+        queueLength = 0;
+        reversePhase = 0.0f;
+        reverseSegmentLength = std::max(1.0f, delayInSamples);
+        onsetDetector.reset();
+    }
+    prevReverseActive = reverseActive;
+    
+    // The reverse engine keeps running while it fades out, and all the time
+    // while its stem is produced.
+    bool reverseRunning = reverseActive || engineMix > 0.0f || context.stemsActive;
+    
+    if (reverseRunning && params.reverseTrigger)
+    {
+        DELAY_TRACE_ZONE("onset detection");
+        context.numOnsets = onsetDetector.process(channelDataL, channelDataR, numSamples);
+    }
+    
+    context.spectralActive = reverseRunning && params.spectral;
+    if (context.spectralActive)
+    {
+        if (!prevSpectralActive)
+        {
+            spectralReverse.reset();
+        }
+        float segmentTime = params.tempoSync ? syncedTime : params.getTargetDelayTime();
+        int segmentLength = static_cast<int>(segmentTime / 1000.0f * sampleRate);
+        
+        // Offline the ring grows right here, so a render never depends on
+        // when the background thread gets to it.
+        if (isNonRealtime())
+        {
+            spectralReverse.reserve(segmentLength);
+        }
+        spectralReverse.setSegmentLength(segmentLength);
+        spectralReverse.setFreeze(params.freeze);
+        spectralReverse.setBlur(params.blur);
+    }
+    prevSpectralActive = context.spectralActive;
+    
+    feedbackFilter.setSlope(static_cast<FeedbackFilter::Slope>(params.feedbackSlope));
+    
+    // While any parameter is still ramping, the general kernel runs in short
+    // sub-blocks. As soon as everything has settled, the rest of the block
+    // goes through a kernel with the parameters held constant and every
+    // stage that currently does nothing compiled out.
+    int sample = 0;
+    [[maybe_unused]] int numKernelCalls = 0;
+    while (sample < numSamples)
+    {
+        ++numKernelCalls;
+        bool includeDelayTime = !params.tempoSync;
+        bool crossfading = isCrossfadingEngines();
+        bool fadingBypass = isFadingBypass();
+        
+        // Only the forward engine has a settled tail kernel. The reverse tail
+        // goes through the general kernel, which is per sample anyway.
+        bool reverseTail = bypassMix >= 1.0f && reverseActive;
+        
+        // Only the general kernel runs both engines side by side, which the
+        // stems need.
+        bool ramping = crossfading || fadingBypass || reverseTail || context.stemsActive
+                    || params.isSmoothing(includeDelayTime);
+        
+        // Gain and mix only act on the output, so the forward block kernel
+        // can follow their ramps when they are rendered up front.
+        bool rampOutput = ramping && !crossfading && !fadingBypass && bypassMix <= 0.0f && !reverseActive
+                       && !context.stemsActive && params.isOnlyOutputSmoothing(includeDelayTime);
+        
+        if (ramping && !rampOutput)
+        {
+            int end = std::min(numSamples, sample + rampSubBlockSize);
+            Kernel kernel = reverseActive ? &DelayAudioProcessor::processKernel<true, true, true, true, MixMode::blend>
+                                          : &DelayAudioProcessor::processKernel<false, true, true, true, MixMode::blend>;
+            if (!filtersRunning)
+            {
+                feedbackFilter.reset();
+                filtersRunning = true;
+            }
+            DELAY_TRACE_ZONE("general kernel");
+            (this->*kernel)(channelDataL, channelDataR, sample, end, context);
+            sample = end;
+        }
+        else
+        {
+            int end = numSamples;
+            if (rampOutput)
+            {
+                end = std::min(numSamples, sample + scratch.getNumSamples() - 1);
+                DELAY_TRACE_ZONE("output ramps");
+                params.renderOutputRamps(scratch.getWritePointer(gainRamp), scratch.getWritePointer(mixRamp), end - sample);
+            }
+            else
+            {
+                // Picks up the settled values once for the rest of the block.
+                params.smoothen();
+            }
+            
+            bool feedbackActive = params.feedback > 0.0f;
+            bool filtersEngaged = feedbackActive && (params.lowCut > 20.0f || params.highCut < 20000.0f);
+            MixMode mix = params.mix >= 1.0f ? MixMode::wet
+                        : params.mix <= 0.0f ? MixMode::dry
+                        : MixMode::blend;
+            
+            if (filtersEngaged)
+            {
+                if (!filtersRunning)
+                {
+                    feedbackFilter.reset();
+                }
+                DELAY_TRACE_ZONE("filter coefficients");
+                feedbackFilter.setCutoffs(params.lowCut, params.highCut);
+            }
+            filtersRunning = filtersEngaged;
+            
+            Kernel kernel = bypassMix >= 1.0f ? &DelayAudioProcessor::processForwardTail
+                          : rampOutput ? selectRampedOutputKernel(feedbackActive, filtersEngaged)
+                          : reverseActive ? selectSettledKernel<true>(feedbackActive, filtersEngaged, mix)
+                          : selectSettledKernel<false>(feedbackActive, filtersEngaged, mix);
+            DELAY_TRACE_ZONE(bypassMix >= 1.0f ? "forward tail"
+                             : rampOutput ? "ramped forward kernel"
+                             : reverseActive ? "reverse kernel"
+                             : "forward kernel");
+            (this->*kernel)(channelDataL, channelDataR, sample, end, context);
+            sample = end;
+        }
+    }
+    
+    DELAY_TRACE_COUNTER("kernel calls", numKernelCalls);
+    checkLoop(channelDataL, channelDataR, numSamples);
+    historyCapture.process(delayLine, numSamples);
+    publishWaveform((params.tempoSync ? syncedTime : params.delayTime) / 1000.0f * sampleRate, numSamples);
+    
+    if (bypassed && bypassMix >= 1.0f)
+    {
+        float delayTime = params.tempoSync ? syncedTime : std::max(params.delayTime, params.getTargetDelayTime());
+        updateTail(delayTime / 1000.0f * sampleRate, numSamples);
+    }
+    else
+    {
+        tailPeak = 0.0f;
+        tailSilence = 0;
+    }
+}
+
+void DelayAudioProcessor::updateTail(float delayInSamples, int numSamples) noexcept
+{
+    tailSilence = tailPeak > tailThreshold ? 0 : tailSilence + numSamples;
+    tailPeak = 0.0f;
+    
+    // A reverse segment comes out up to two segments after it went in, and
+    // the spectral engine adds its own latency on top.
+    float longestEcho = 2.0f * delayInSamples + float(reverseFadeLength + spectralReverse.getLatency());
+    if (float(tailSilence) <= longestEcho)
+    {
+        return;
+    }
+    
+    // The histories hold nothing audible any more. Clearing them now means
+    // un-bypassing later starts from silence, like a fresh instance.
+    clearEngines();
+    tailSilence = 0;
+    tailIdle = true;
+}
+
+void DelayAudioProcessor::clearEngines() noexcept
+{
+    delayLine.reset();
+    feedbackL = 0.0f;
+    feedbackR = 0.0f;
+    feedbackFilter.reset();
+    filtersRunning = false;
+    dcBlocker.reset();
+    
+    reverseHead = {};
+    fadingHead = {};
+    queueLength = 0;
+    reversePhase = 0.0f;
+    reverseSegmentLength = 0.0f;
+    onsetDetector.reset();
+    prevSpectralActive = false;
+    
+    // The resamplers hold a few samples of the wet signal. They only work
+    // as a pair, so both sides start over.
+    decimator.reset();
+    for (auto& interpolator : interpolators)
+    {
+        interpolator.reset();
+    }
+    
+    multiLane.reset();
+}
+
+void DelayAudioProcessor::checkInput(float* channelDataL, float* channelDataR, int numSamples) noexcept
+{
+    if (std::isfinite(kernels->peak(channelDataL, channelDataR, numSamples)))
+    {
+        return;
+    }
+    
+    // One bad sample in the history would come back with every repeat and
+    // spread through the filters, so it never gets that far.
+    replaceNonFinite(channelDataL, numSamples);
+    replaceNonFinite(channelDataR, numSamples);
+    numCorruptBlocks.fetch_add(1, std::memory_order_relaxed);
+}
+
+void DelayAudioProcessor::checkLoop(float* channelDataL, float* channelDataR, int numSamples) noexcept
+{
+    // The output holds the wet signal unless the mix is fully dry, and then
+    // the feedback carried into the next block still shows a bad loop.
+    bool healthy = std::isfinite(kernels->peak(channelDataL, channelDataR, numSamples))
+                && std::isfinite(feedbackL) && std::isfinite(feedbackR);
+    
+    if (healthy && recoveryGain >= 1.0f)
+    {
+        return;
+    }
+    
+    // Fades out what is left of a bad block and clears the loop, then fades
+    // the following blocks back in.
+    float targetGain = 0.0f;
+    if (healthy)
+    {
+        targetGain = std::min(1.0f, recoveryGain + recoveryStep * float(numSamples));
+    }
+    else
+    {
+        DELAY_TRACE_ZONE("loop recovery");
+        replaceNonFinite(channelDataL, numSamples);
+        replaceNonFinite(channelDataR, numSamples);
+        clearEngines();
+        numCorruptBlocks.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    float step = (targetGain - recoveryGain) / float(numSamples);
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float gain = recoveryGain + step * float(i + 1);
+        channelDataL[i] *= gain;
+        channelDataR[i] *= gain;
+    }
+    recoveryGain = targetGain;
+}
+
+void DelayAudioProcessor::replaceNonFinite(float* data, int numSamples) noexcept
+{
+    for (int i = 0; i < numSamples; ++i)
+    {
+        if (!std::isfinite(data[i]))
+        {
+            data[i] = 0.0f;
+        }
+    }
+}
+
+bool DelayAudioProcessor::transportJumped(const juce::Optional<juce::AudioPlayHead::PositionInfo>& position,
+                                          int numSamples) noexcept
+{
+    bool playing = false;
+    juce::Optional<juce::int64> time;
+    if (position.hasValue())
+    {
+        playing = position->getIsPlaying();
+        time = position->getTimeInSamples();
+    }
+    
+    // Some hosts keep the time in seconds, so the position may be a
+    // sample off after rounding.
+    bool stopped = wasTransportPlaying && !playing;
+    bool moved = wasTransportPlaying && playing && time.hasValue() && nextTransportTime >= 0
+              && std::abs(*time - nextTransportTime) > 1;
+    
+    wasTransportPlaying = playing;
+    nextTransportTime = time.hasValue() ? *time + numSamples : -1;
+    return stopped || moved;
+}
+
+void DelayAudioProcessor::processIdle(float* channelDataL, float* channelDataR, int numSamples, bool dryInOutput) noexcept
+{
+    // The dry signal still has to match the latency reported to the host.
+    if (!dryInOutput)
+    {
+        juce::FloatVectorOperations::clear(channelDataL, numSamples);
+        juce::FloatVectorOperations::clear(channelDataR, numSamples);
+    }
+    else if (params.lookahead)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dryDelayLine.pushSample(channelDataL[i], channelDataR[i]);
+            dryDelayLine.popSample(dryDelay, channelDataL[i], channelDataR[i]);
+        }
+    }
+    
+    // Both engines are empty, so switching between them needs no fade.
+    engineMix = reverseActive ? 1.0f : 0.0f;
+    prevReverseActive = reverseActive;
+}
+
+void DelayAudioProcessor::publishWaveform(float delayInSamples, int numSamples) noexcept
+{
+    if (!waveformFeed.isActive())
+    {
+        return;
+    }
+    
+    DELAY_TRACE_ZONE("waveform");
+    bool reverseRunning = reverseActive || engineMix > 0.0f;
+    int segmentAge = reverseRunning ? static_cast<int>(reversePhase) : -1;
+    float forwardDelay = engineMix < 1.0f ? delayInSamples : -1.0f;
+    bool headPlaying = reverseHead.remaining > 0.0f && reverseHead.remaining <= reverseHead.length;
+    float reverseDelay = reverseRunning && headPlaying ? reverseHead.delay : -1.0f;
+    
+    // The kernels are done with the scratch space by now. Reading the block
+    // back from the history shows exactly what the engines will play.
+    float* left = scratch.getWritePointer(wetLeft);
+    float* right = scratch.getWritePointer(wetRight);
+    int sliceSize = scratch.getNumSamples();
+    for (int start = 0; start < numSamples; start += sliceSize)
+    {
+        int length = std::min(sliceSize, numSamples - start);
+        bool last = start + length == numSamples;
+        delayLine.copyHistory(left, right, numSamples - start, length);
+        waveformFeed.push(left, right, length, last ? segmentAge : -1, forwardDelay, reverseDelay);
+    }
+}
+
+template<bool Reverse>
+DelayAudioProcessor::Kernel DelayAudioProcessor::selectSettledKernel(bool feedback, bool filters, MixMode mix) noexcept
+{
+    // The filters only sit in the feedback path, so they matter only with feedback.
+    if (feedback && filters)
+    {
+        return selectMixKernel<Reverse, true, true>(mix);
+    }
+    else if (feedback)
+    {
+        return selectMixKernel<Reverse, true, false>(mix);
+    }
+    return selectMixKernel<Reverse, false, false>(mix);
+}
+
+DelayAudioProcessor::Kernel DelayAudioProcessor::selectRampedOutputKernel(bool feedback, bool filters) noexcept
+{
+    if (feedback && filters)
+    {
+        return &DelayAudioProcessor::processForwardBlock<true, true, true>;
+    }
+    else if (feedback)
+    {
+        return &DelayAudioProcessor::processForwardBlock<true, false, true>;
+    }
+    return &DelayAudioProcessor::processForwardBlock<false, false, true>;
+}
+
+template<bool Reverse, bool Feedback, bool Filters>
+DelayAudioProcessor::Kernel DelayAudioProcessor::selectMixKernel(MixMode mix) noexcept
+{
+    // The forward engine works on whole chunks and folds the mix into two
+    // gains, so it needs no separate versions for the mix modes.
+    if constexpr (!Reverse)
+    {
+        return &DelayAudioProcessor::processForwardBlock<Feedback, Filters, false>;
+    }
+    else
+    {
+        switch (mix)
+        {
+            case MixMode::wet:
+                return &DelayAudioProcessor::processKernel<Reverse, false, Feedback, Filters, MixMode::wet>;
+            case MixMode::dry:
+                return &DelayAudioProcessor::processKernel<Reverse, false, Feedback, Filters, MixMode::dry>;
+            case MixMode::blend:
+                break;
+        }
+        return &DelayAudioProcessor::processKernel<Reverse, false, Feedback, Filters, MixMode::blend>;
+    }
+}
+
+template<bool Reverse, bool Ramping, bool Feedback, bool Filters, DelayAudioProcessor::MixMode Mix>
+void DelayAudioProcessor::processKernel(float* channelDataL, float* channelDataR,
+                                        int startSample, int endSample, BlockContext& context) noexcept
+{
+    float delayInSamples = 0.0f;
+    
+    if constexpr (!Ramping)
+    {
+        float delayTime = params.tempoSync ? context.syncedTime : params.delayTime;
+        delayInSamples = delayTime / 1000.0f * context.sampleRate;
+    }
+    
+    if constexpr (!Feedback)
+    {
+        feedbackL = 0.0f;
+        feedbackR = 0.0f;
+    }
+    
+    for (int sample = startSample; sample < endSample; ++sample)
+    {
+        if constexpr (Ramping)
+        {
+            params.smoothen();
+            
+            float delayTime = params.tempoSync ? context.syncedTime : params.delayTime;
+            delayInSamples = delayTime / 1000.0f * context.sampleRate;
+            
+            feedbackFilter.setCutoffs(params.lowCut, params.highCut);
+        }
+        
+        float inputLevel = 1.0f;
+        if constexpr (Ramping)
+        {
+            inputLevel = 1.0f - bypassMix;
+        }
+        
+        float dryL = channelDataL[sample];
+        float dryR = channelDataR[sample];
+        
+        float mono = (dryL + dryR) * 0.5f * inputLevel;
+        
+        if (!context.dryInOutput)
+        {
+            dryL = 0.0f;
+            dryR = 0.0f;
+        }
+        else if (params.lookahead)
+        {
+            dryDelayLine.pushSample(dryL, dryR);
+            dryDelayLine.popSample(dryDelay, dryL, dryR);
+        }
+        
+        if (Ramping && context.stemsActive)
+        {
+            writeStem(context, dryStem, sample, dryL, dryR);
+        }
+        
+        float inputL = mono*params.panL + feedbackR;
+        float inputR = mono*params.panR + feedbackL;
+        float wetL, wetR;
+        
+        // Only the general kernel handles the crossfade and the stems, so the
+        // settled kernels never run more than one engine.
+        if (Ramping && (isCrossfadingEngines() || context.stemsActive))
+        {
+            crossfadeEngines(inputL, inputR, delayInSamples, sample, context, wetL, wetR);
+        }
+        else if constexpr (Reverse)
+        {
+            processReverseSample(inputL, inputR, delayInSamples, sample, context, wetL, wetR);
+        }
+        else
+        {
+            delayLine.pushSample(inputL, inputR);
+            delayLine.popSample(delayInSamples, wetL, wetR);
+        }
+        
+        if constexpr (Feedback)
+        {
+            feedbackL = wetL * params.feedback;
+            feedbackR = wetR * params.feedback;
+            
+            if constexpr (Filters)
+            {
+                feedbackFilter.processSample(feedbackL, feedbackR);
+            }
+            dcBlocker.processSample(feedbackL, feedbackR);
+        }
+        
+        float mixL, mixR;
+        if constexpr (Mix == MixMode::wet)
+        {
+            mixL = wetL;
+            mixR = wetR;
+        }
+        else if constexpr (Mix == MixMode::dry)
+        {
+            mixL = dryL;
+            mixR = dryR;
+        }
+        else
+        {
+            mixL = dryL * (1.0f - params.mix) * inputLevel + wetL * params.mix;
+            mixR = dryR * (1.0f - params.mix) * inputLevel + wetR * params.mix;
+        }
+        
+        channelDataL[sample] = mixL * params.gain;
+        channelDataR[sample] = mixR * params.gain;
+        
+        // While bypassing, the dry signal rises to unity on its own and the
+        // wet signal already in flight keeps its level.
+        if constexpr (Ramping)
+        {
+            channelDataL[sample] += dryL * bypassMix;
+            channelDataR[sample] += dryR * bypassMix;
+            tailPeak = std::max(tailPeak, std::max(std::abs(wetL), std::abs(wetR)));
+            
+            bypassMix = bypassed ? std::min(1.0f, bypassMix + bypassFadeStep)
+                                 : std::max(0.0f, bypassMix - bypassFadeStep);
+        }
+        
+        // A non-finite sample here would end up in the feedback path for good.
+        jassert(std::isfinite(channelDataL[sample]) && std::isfinite(channelDataR[sample]));
+    }
+}
+
+template<bool Feedback, bool Filters, bool RampedOutput>
+void DelayAudioProcessor::processForwardBlock(float* channelDataL, float* channelDataR,
+                                              int startSample, int endSample, BlockContext& context) noexcept
+{
+    float delayTime = params.tempoSync ? context.syncedTime : params.delayTime;
+    float delayInSamples = delayTime / 1000.0f * context.sampleRate;
+    
+    // The feedback loop only closes through the delay, so a chunk that is
+    // not longer than the delay never reads its own output. That is what
+    // lets every stage below run over the whole chunk at once.
+    int maxChunkSize = std::min(scratch.getNumSamples() - 1, static_cast<int>(delayInSamples));
+    jassert(maxChunkSize > 0);
+    
+    float* wetL = scratch.getWritePointer(wetLeft);
+    float* wetR = scratch.getWritePointer(wetRight);
+    float* fbL = scratch.getWritePointer(feedbackLeft);
+    float* fbR = scratch.getWritePointer(feedbackRight);
+    float* inputL = scratch.getWritePointer(inputLeft);
+    float* inputR = scratch.getWritePointer(inputRight);
+    
+    float dryGain = (1.0f - params.mix) * params.gain;
+    float wetGain = params.mix * params.gain;
+    
+    if constexpr (!Feedback)
+    {
+        feedbackL = 0.0f;
+        feedbackR = 0.0f;
+    }
+    
+    for (int start = startSample; start < endSample; start += maxChunkSize)
+    {
+        int chunkSize = std::min(maxChunkSize, endSample - start);
+        float* dryL = channelDataL + start;
+        float* dryR = channelDataR + start;
+        
+        delayLine.read(wetL, wetR, delayInSamples, chunkSize);
+        
+        // Every sample is fed the feedback of the sample before it, so the
+        // feedback is written one slot ahead of the wet signal it comes from.
+        if constexpr (Feedback)
+        {
+            fbL[0] = feedbackL;
+            fbR[0] = feedbackR;
+            kernels->scale(fbL + 1, fbR + 1, wetL, wetR, params.feedback, chunkSize);
+            
+            if constexpr (Filters)
+            {
+                feedbackFilter.process(fbL + 1, fbR + 1, chunkSize);
+            }
+            dcBlocker.process(fbL + 1, fbR + 1, chunkSize);
+            
+            feedbackL = fbL[chunkSize];
+            feedbackR = fbR[chunkSize];
+        }
+        else
+        {
+            juce::FloatVectorOperations::clear(fbL, chunkSize);
+            juce::FloatVectorOperations::clear(fbR, chunkSize);
+        }
+        
+        kernels->panInput(inputL, inputR, dryL, dryR, fbL, fbR, params.panL, params.panR, chunkSize);
+        delayLine.write(inputL, inputR, chunkSize);
+        
+        if (!context.dryInOutput)
+        {
+            juce::FloatVectorOperations::clear(dryL, chunkSize);
+            juce::FloatVectorOperations::clear(dryR, chunkSize);
+        }
+        else if (params.lookahead)
+        {
+            for (int i = 0; i < chunkSize; ++i)
+            {
+                dryDelayLine.pushSample(dryL[i], dryR[i]);
+                dryDelayLine.popSample(dryDelay, dryL[i], dryR[i]);
+            }
+        }
+        
+        if constexpr (RampedOutput)
+        {
+            int offset = start - startSample;
+            kernels->mixRamped(dryL, dryR, dryL, dryR, wetL, wetR,
+                               scratch.getReadPointer(gainRamp, offset), scratch.getReadPointer(mixRamp, offset), chunkSize);
+        }
+        else
+        {
+            kernels->mix(dryL, dryR, dryL, dryR, wetL, wetR, dryGain, wetGain, chunkSize);
+        }
+        
+        for (int i = 0; i < chunkSize; ++i)
+        {
+            jassert(std::isfinite(dryL[i]) && std::isfinite(dryR[i]));
+        }
+    }
+}
+
+void DelayAudioProcessor::processForwardTail(float* channelDataL, float* channelDataR,
+                                             int startSample, int endSample, BlockContext& context) noexcept
+{
+    float delayTime = params.tempoSync ? context.syncedTime : params.delayTime;
+    float delayInSamples = delayTime / 1000.0f * context.sampleRate;
+    int maxChunkSize = std::min(scratch.getNumSamples() - 1, static_cast<int>(delayInSamples));
+    
+    float* wetL = scratch.getWritePointer(wetLeft);
+    float* wetR = scratch.getWritePointer(wetRight);
+    float* fbL = scratch.getWritePointer(feedbackLeft);
+    float* fbR = scratch.getWritePointer(feedbackRight);
+    
+    float wetGain = params.mix * params.gain;
+    bool feedbackActive = params.feedback > 0.0f;
+    
+    for (int start = startSample; start < endSample; start += maxChunkSize)
+    {
+        int chunkSize = std::min(maxChunkSize, endSample - start);
+        float* dryL = channelDataL + start;
+        float* dryR = channelDataR + start;
+        
+        delayLine.read(wetL, wetR, delayInSamples, chunkSize);
+        
+        // The input is no longer written, only the feedback, crossed over
+        // the same way panInput does it.
+        if (feedbackActive)
+        {
+            fbL[0] = feedbackL;
+            fbR[0] = feedbackR;
+            kernels->scale(fbL + 1, fbR + 1, wetL, wetR, params.feedback, chunkSize);
+            
+            if (filtersRunning)
+            {
+                feedbackFilter.process(fbL + 1, fbR + 1, chunkSize);
+            }
+            dcBlocker.process(fbL + 1, fbR + 1, chunkSize);
+            
+            feedbackL = fbL[chunkSize];
+            feedbackR = fbR[chunkSize];
+        }
+        else
+        {
+            juce::FloatVectorOperations::clear(fbL, chunkSize);
+            juce::FloatVectorOperations::clear(fbR, chunkSize);
+            feedbackL = 0.0f;
+            feedbackR = 0.0f;
+        }
+        delayLine.write(fbR, fbL, chunkSize);
+        
+        if (!context.dryInOutput)
+        {
+            juce::FloatVectorOperations::clear(dryL, chunkSize);
+            juce::FloatVectorOperations::clear(dryR, chunkSize);
+        }
+        else if (params.lookahead)
+        {
+            for (int i = 0; i < chunkSize; ++i)
+            {
+                dryDelayLine.pushSample(dryL[i], dryR[i]);
+                dryDelayLine.popSample(dryDelay, dryL[i], dryR[i]);
+            }
+        }
+        
+        juce::FloatVectorOperations::addWithMultiply(dryL, wetL, wetGain, chunkSize);
+        juce::FloatVectorOperations::addWithMultiply(dryR, wetR, wetGain, chunkSize);
+        
+        auto rangeL = juce::FloatVectorOperations::findMinAndMax(wetL, chunkSize);
+        auto rangeR = juce::FloatVectorOperations::findMinAndMax(wetR, chunkSize);
+        tailPeak = std::max({ tailPeak, -rangeL.getStart(), rangeL.getEnd(), -rangeR.getStart(), rangeR.getEnd() });
+    }
+}
+
+void DelayAudioProcessor::processReverseSample(float inputL, float inputR, float delayInSamples, int sample,
+                                               BlockContext& context, float& wetL, float& wetR) noexcept
+{
+    delayLine.pushSample(inputL, inputR);
+    reversePhase += 1.0f;
+    ++reverseClock;
+    
+    // Plays a captured segment backwards.
+    wetL = 0.0f;
+    wetR = 0.0f;
+    
+    bool played = reverseHead.remaining > 0.0f && reverseHead.remaining <= reverseHead.length;
+    float playedDelay = reverseHead.delay;
+    if (played)
+    {
+        delayLine.popSample(reverseHead.delay, wetL, wetR);
+    }
+    if (reverseHead.remaining > 0.0f)
+    {
+        reverseHead.delay += 2.0f;
+        reverseHead.remaining -= 1.0f;
+    }
+    
+    if (fadingHead.remaining > 0.0f)
+    {
+        float fadeL, fadeR;
+        delayLine.popSample(fadingHead.delay, fadeL, fadeR);
+        float fadeGain = fadingHead.remaining / float(reverseFadeLength);
+        wetL += fadeL * fadeGain;
+        wetR += fadeR * fadeGain;
+        fadingHead.delay += 2.0f;
+        fadingHead.remaining -= 1.0f;
+    }
+    
+    // The spectral engine replaces the wet signal but the segment
+    // bookkeeping above keeps running, so switching back is seamless.
+    if (context.spectralActive)
+    {
+        spectralReverse.processSample(inputL, inputR, wetL, wetR);
+    }
+    
+    // An onset found in the hop that ends here moves the segment start
+    // back to where its attack begins, so the transient is the first sample
+    // of the new segment.
+    bool onset = false;
+    float attackLength = 0.0f;
+    if (context.nextOnset < context.numOnsets && onsetDetector.getOnset(context.nextOnset) == sample)
+    {
+        attackLength = float(onsetDetector.getAttackLength(context.nextOnset));
+        ++context.nextOnset;
+        onset = reversePhase - attackLength >= float(context.minSegmentLength);
+    }
+    
+    // The segment ends where the phase crosses its length, which is usually
+    // a fraction of a sample ago. That fraction carries over into the next
+    // segment and sets where the new head starts reading. A new delay time
+    // only takes effect here, so a segment never changes length halfway.
+    if (reversePhase >= reverseSegmentLength || onset)
+    {
+        float carryOver = onset ? attackLength : reversePhase - reverseSegmentLength;
+        float length = reversePhase - carryOver;
+        
+        // The head reaches the first sample of the segment two full lengths
+        // after it went in, less one, which is the latency lookahead reports.
+        // A segment cut short by an onset therefore waits in silence for
+        // twice what it is short by, less the samples the onset took to be
+        // found. The next sample is pushed before it is read, hence the
+        // extra one in the delay.
+        float remaining = std::max(length, 2.0f * reverseSegmentLength - length - carryOver);
+        queueReverseHead({ carryOver + 1.0f + length - remaining, remaining, length });
+        
+        reversePhase = carryOver;
+        reverseSegmentLength = std::max(1.0f, delayInSamples);
+    }
+    
+    // A segment takes over once the one before it is done. Whatever part of
+    // it would have played before then is skipped, so the newest samples go
+    // and it still ends on its first sample. A head with less than a sample
+    // left gives way at once.
+    while (reverseHead.remaining < 1.0f && queueLength > 0)
+    {
+        auto& queued = headQueue[size_t(queueStart)];
+        float waited = float(reverseClock - queued.queuedAt);
+        reverseHead = queued.head;
+        reverseHead.delay += 2.0f * waited;
+        reverseHead.remaining -= waited;
+        queueStart = (queueStart + 1) % int(headQueue.size());
+        --queueLength;
+    }
+    
+    // A head that stops without another one carrying on fades out instead,
+    // unless a full segment is about to be captured and play right away.
+    bool playsNext = reverseHead.remaining > 0.0f && reverseHead.remaining <= reverseHead.length;
+    bool segmentEndsNext = queueLength == 0 && reverseSegmentLength - reversePhase < 1.0f;
+    if (played && !playsNext && !segmentEndsNext)
+    {
+        fadeOutReverseHead(playedDelay + 2.0f);
+    }
+}
+
+void DelayAudioProcessor::queueReverseHead(const ReverseHead& head) noexcept
+{
+    // A head that would end before the last one queued, which happens when
+    // the delay time drops, would never get to play.
+    float lastRemaining = reverseHead.remaining;
+    if (queueLength > 0)
+    {
+        const auto& last = headQueue[size_t((queueStart + queueLength - 1) % int(headQueue.size()))];
+        lastRemaining = last.head.remaining - float(reverseClock - last.queuedAt);
+    }
+    if (head.remaining <= lastRemaining || queueLength == int(headQueue.size()))
+    {
+        return;
+    }
+    
+    headQueue[size_t((queueStart + queueLength) % int(headQueue.size()))] = { head, reverseClock };
+    ++queueLength;
+}
+
+void DelayAudioProcessor::crossfadeEngines(float inputL, float inputR, float delayInSamples, int sample,
+                                           BlockContext& context, float& wetL, float& wetR) noexcept
+{
+    // The reverse engine writes the shared history, then the forward engine
+    // reads from the same place.
+    float reverseL, reverseR;
+    processReverseSample(inputL, inputR, delayInSamples, sample, context, reverseL, reverseR);
+    
+    float forwardL, forwardR;
+    delayLine.popSample(delayInSamples, forwardL, forwardR);
+    
+    if (context.stemsActive)
+    {
+        writeStem(context, forwardStem, sample, forwardL, forwardR);
+        writeStem(context, reverseStem, sample, reverseL, reverseR);
+    }
+    
+    if (!isCrossfadingEngines())
+    {
+        // Both engines only run for the stems, and one of them is silent.
+        wetL = reverseActive ? reverseL : forwardL;
+        wetR = reverseActive ? reverseR : forwardR;
+        return;
+    }
+    
+    // The two engines play unrelated material, so an equal-power curve
+    // keeps the level steady through the fade.
+    float angle = engineMix * juce::MathConstants<float>::halfPi;
+    float forwardGain = std::cos(angle);
+    float reverseGain = std::sin(angle);
+    wetL = forwardL * forwardGain + reverseL * reverseGain;
+    wetR = forwardR * forwardGain + reverseR * reverseGain;
+    
+    engineMix = reverseActive ? std::min(1.0f, engineMix + engineFadeStep)
+                              : std::max(0.0f, engineMix - engineFadeStep);
+}
+
+void DelayAudioProcessor::writeStem(BlockContext& context, Stem stem, int sample, float left, float right) const noexcept
+{
+    // Stems are taken before the mix but after the output gain.
+    if (float* stemLeft = context.stemLeft[stem])
+    {
+        stemLeft[sample] = left * params.gain;
+        context.stemRight[stem][sample] = right * params.gain;
+    }
+}
+
+void DelayAudioProcessor::fadeOutReverseHead(float delay) noexcept
+{
+    // A head that is still fading is simply dropped, which only happens
+    // when segments are shorter than the fade.
+    fadingHead.delay = delay;
+    fadingHead.remaining = float(reverseFadeLength);
+    fadingHead.length = fadingHead.remaining;
+}
+
+bool DelayAudioProcessor::captureHistory(const juce::File& file, double seconds)
+{
+    // The history runs at the engine rate.
+    double sampleRate = engineSampleRate;
+    int numSamples = int(std::min(seconds, getMaxCaptureSeconds()) * sampleRate);
+    return sampleRate > 0.0 && historyCapture.request(file, numSamples, sampleRate);
+}
+
+void DelayAudioProcessor::setCompactStorage(bool shouldBeCompact)
+{
+    apvts.state.setProperty(compactStorageProperty, shouldBeCompact, nullptr);
+}
+
+bool DelayAudioProcessor::isCompactStorage() const
+{
+    return apvts.state.getProperty(compactStorageProperty, false);
+}
+
+void DelayAudioProcessor::setPipelined(bool shouldBePipelined)
+{
+    apvts.state.setProperty(pipelinedProperty, shouldBePipelined, nullptr);
+}
+
+bool DelayAudioProcessor::isPipelined() const
+{
+    return apvts.state.getProperty(pipelinedProperty, false);
+}
+
+void DelayAudioProcessor::setFlushOnTransport(bool shouldFlush)
+{
+    apvts.state.setProperty(flushOnTransportProperty, shouldFlush, nullptr);
+}
+
+bool DelayAudioProcessor::isFlushOnTransport() const
+{
+    return apvts.state.getProperty(flushOnTransportProperty, true);
+}
+
+void DelayAudioProcessor::setDecimatedWet(bool shouldBeDecimated)
+{
+    apvts.state.setProperty(decimatedWetProperty, shouldBeDecimated, nullptr);
+}
+
+bool DelayAudioProcessor::isDecimatedWet() const
+{
+    return apvts.state.getProperty(decimatedWetProperty, false);
+}
+
+void DelayAudioProcessor::setReverbImpulse(const juce::File& file)
+{
+    apvts.state.setProperty(reverbImpulseProperty, file.getFullPathName(), nullptr);
+}
+
+juce::File DelayAudioProcessor::getReverbImpulse() const
+{
+    juce::String path = apvts.state.getProperty(reverbImpulseProperty, juce::String()).toString();
+    return juce::File::isAbsolutePath(path) ? juce::File(path) : juce::File();
+}
+
+void DelayAudioProcessor::setReverbLength(double seconds)
+{
+    apvts.state.setProperty(reverbLengthProperty, seconds, nullptr);
+}
+
+double DelayAudioProcessor::getReverbLength() const
+{
+    double seconds = apvts.state.getProperty(reverbLengthProperty, 2.0);
+    return std::clamp(seconds, 0.1, maxReverbSeconds);
+}
+
+void DelayAudioProcessor::setReverbWorker(bool shouldUseWorker)
+{
+    apvts.state.setProperty(reverbWorkerProperty, shouldUseWorker, nullptr);
+}
+
+bool DelayAudioProcessor::isReverbWorker() const
+{
+    return apvts.state.getProperty(reverbWorkerProperty, true);
+}
+
+void DelayAudioProcessor::setLaneSettings(int lane, const LaneSettings& settings)
+{
+    jassert(lane >= 0 && lane < MultiLaneDelay::maxLanes);
+    auto node = apvts.state.getChildWithProperty("lane", lane);
+    if (!node.isValid())
+    {
+        node = juce::ValueTree(laneType);
+        node.setProperty("lane", lane, nullptr);
+        apvts.state.appendChild(node, nullptr);
+    }
+    node.setProperty("timeScale", settings.timeScale, nullptr);
+    node.setProperty("feedbackScale", settings.feedbackScale, nullptr);
+    node.setProperty("stereo", settings.stereo, nullptr);
+}
+
+DelayAudioProcessor::LaneSettings DelayAudioProcessor::getLaneSettings(int lane) const
+{
+    // The lanes stop at maxLaneDelayTime and the feedback at 100% whatever
+    // the factors, so these limits only keep the values sensible.
+    auto node = apvts.state.getChildWithProperty("lane", lane);
+    LaneSettings settings;
+    settings.timeScale = std::clamp(float(node.getProperty("timeScale", 1.0f)), 0.125f, 8.0f);
+    settings.feedbackScale = std::clamp(float(node.getProperty("feedbackScale", 1.0f)), 0.0f, 2.0f);
+    settings.stereo = std::clamp(float(node.getProperty("stereo", 0.0f)), -2.0f, 2.0f);
+    return settings;
+}
+
+int DelayAudioProcessor::chooseDecimation(double sampleRate) noexcept
+{
+    // Halves the rate while it stays at 44.1 kHz or above.
+    int factor = 1;
+    while (factor < 4 && sampleRate / (2 * factor) >= 44100.0)
+    {
+        factor *= 2;
+    }
+    return factor;
+}
+
+//==============================================================================
+bool DelayAudioProcessor::hasEditor() const
+{
+    return true; // (change this to false if you choose to not supply an editor)
+}
+
+juce::AudioProcessorEditor* DelayAudioProcessor::createEditor()
+{
+    return new DelayAudioProcessorEditor (*this);
+}
+
+//==============================================================================
+void DelayAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
+{
+    DELAY_TRACE_ZONE("getStateInformation");
+    copyXmlToBinary(*apvts.copyState().createXml(), destData);
+}
+
+void DelayAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
+{
+    DELAY_TRACE_ZONE("setStateInformation");
+    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+    if (xml.get() != nullptr && xml->hasTagName(apvts.state.getType()))
+    {
+        // Older sessions store the delay time under its old ID. The value is
+        // in milliseconds and inside the new range, so only the ID changes.
+        auto state = juce::ValueTree::fromXml(*xml);
+        auto legacyDelayTime = state.getChildWithProperty("id", legacyDelayTimeParamID.getParamID());
+        if (legacyDelayTime.isValid() && !state.getChildWithProperty("id", delayTimeParamID.getParamID()).isValid())
+        {
+            legacyDelayTime.setProperty("id", delayTimeParamID.getParamID(), nullptr);
+        }
+        apvts.replaceState(state);
     }
 }
 
@@ -11,6 +11,18 @@
 #include <JuceHeader.h>
 #include "Parameters.h"
 #include "Tempo.h"
+#include "OnsetDetector.h"
+#include "SpectralReverse.h"
+#include "DelayBuffer.h"
+#include "FeedbackFilter.h"
+#include "DSP.h"
+#include "Trace.h"
+#include "HistoryCapture.h"
+#include "Pipeline.h"
+#include "WaveformFeed.h"
+#include "HalfBandResampler.h"
+#include "MultiLaneDelay.h"
+#include "ReverseReverb.h"
 
 
 //==============================================================================
@@ -26,10 +38,42 @@ public:
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     
-    int reverseReadPointer = 0;
     bool prevReverseActive = false;
-    int reverseBlockSampleCount = 0;
-    int reverseBlockStart = 0;
+    
+    // A read head of the reverse engine. It moves backwards through the
+    // captured audio while the write position moves forwards, so its
+    // distance behind the write position grows by two every sample. It
+    // only plays the last `length` of its remaining samples, which are the
+    // ones inside its segment, and waits in silence before that.
+    struct ReverseHead
+    {
+        float delay = 0.0f;
+        float remaining = 0.0f;
+        float length = 0.0f;
+    };
+    ReverseHead reverseHead;
+    ReverseHead fadingHead;
+    
+    // Every segment ends on its first sample at the reported latency, so a
+    // segment that onset mode cut short waits before it plays, and the
+    // segments after it wait here until the one before them is done. Each
+    // is queued with the sample count at the time, and catches up with the
+    // samples it waited for when it takes over.
+    struct QueuedHead
+    {
+        ReverseHead head;
+        juce::int64 queuedAt = 0;
+    };
+    std::vector<QueuedHead> headQueue;
+    int queueStart = 0;
+    int queueLength = 0;
+    juce::int64 reverseClock = 0;
+    
+    // Samples captured into the current segment and the length it will be
+    // cut at. Both are fractional, so the segments follow the delay time
+    // exactly on average. The length is only picked up at a boundary.
+    float reversePhase = 0.0f;
+    float reverseSegmentLength = 0.0f;
     void releaseResources() override;
 
    #ifndef JucePlugin_PreferredChannelConfigurations
@@ -37,6 +81,11 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    
+    // Bypassing stops the input from reaching the engines, but the echoes
+    // already in flight play out before the processor goes idle.
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    juce::AudioProcessorParameter* getBypassParameter() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -67,24 +116,416 @@ public:
     };
 
     Parameters params;
+    
+    // Forces the kernels to one instruction set for A/B tests, or back to
+    // automatic detection with an empty value. Takes effect in prepareToPlay.
+    void forceKernels(std::optional<VectorKernels::Isa> isa) noexcept
+    {
+        forcedKernels = isa;
+    }
+    
+    VectorKernels::Isa getKernelIsa() const noexcept
+    {
+        return kernels->isa;
+    }
+    
+    // Keeps the delay histories as half floats, which halves the memory of
+    // long delays. The choice is saved with the state and takes effect in
+    // prepareToPlay, because the buffers have to be reallocated.
+    static inline const juce::Identifier compactStorageProperty { "compactStorage" };
+    void setCompactStorage(bool shouldBeCompact);
+    bool isCompactStorage() const;
+    
+    // Runs the engines on a worker thread one block behind the host, so a
+    // heavy instance no longer holds up the host's audio thread while it
+    // works. Adds one block of latency. Saved with the state and picked up
+    // in prepareToPlay, like compact storage.
+    static inline const juce::Identifier pipelinedProperty { "pipelined" };
+    void setPipelined(bool shouldBePipelined);
+    bool isPipelined() const;
+    
+    // Runs the engines at 44.1 or 48 kHz when the host runs at two or four
+    // times that, with only the dry signal at the full rate. The wet signal
+    // rarely has anything above 20 kHz, and the histories and the per-sample
+    // work shrink by the same factor. The resampling filters add to the
+    // latency. Saved with the state and picked up in prepareToPlay.
+    static inline const juce::Identifier decimatedWetProperty { "decimatedWet" };
+    void setDecimatedWet(bool shouldBeDecimated);
+    bool isDecimatedWet() const;
+    
+    // Clears the echoes when the host's transport stops, loops or jumps, so
+    // a tail from before never plays over the new position. On by default.
+    // Saved with the state and picked up in prepareToPlay.
+    static inline const juce::Identifier flushOnTransportProperty { "flushOnTransport" };
+    void setFlushOnTransport(bool shouldFlush);
+    bool isFlushOnTransport() const;
+    
+    // The impulse of the reverse reverb, read from an audio file, or noise
+    // decaying over the given length when no file is set. Both are saved
+    // with the state and picked up in prepareToPlay.
+    static inline const juce::Identifier reverbImpulseProperty { "reverbImpulse" };
+    static inline const juce::Identifier reverbLengthProperty { "reverbLength" };
+    static constexpr double maxReverbSeconds = 10.0;
+    void setReverbImpulse(const juce::File& file);
+    juce::File getReverbImpulse() const;
+    void setReverbLength(double seconds);
+    double getReverbLength() const;
+    
+    // Computes the longest partitions of the reverb on a worker thread, so
+    // their FFTs are spread over many blocks. On by default. Saved with the
+    // state and picked up in prepareToPlay.
+    static inline const juce::Identifier reverbWorkerProperty { "reverbWorker" };
+    void setReverbWorker(bool shouldUseWorker);
+    bool isReverbWorker() const;
+    
+    // Spreads the lanes of a multichannel bus apart. Each lane multiplies
+    // the delay time and the feedback by its own factors and adds its own
+    // offset to the Stereo parameter, so the parameters still move all the
+    // lanes together. By default every lane follows them unchanged. Saved
+    // with the state and picked up in prepareToPlay.
+    struct LaneSettings
+    {
+        float timeScale = 1.0f;
+        float feedbackScale = 1.0f;
+        float stereo = 0.0f;
+    };
+    static inline const juce::Identifier laneType { "LANE" };
+    void setLaneSettings(int lane, const LaneSettings& settings);
+    LaneSettings getLaneSettings(int lane) const;
+    
+    // Blocks in which a sample that is not finite was caught, either in the
+    // input, which is then cleaned before it reaches the loop, or in the
+    // loop itself, which then starts over from silence. For the editor.
+    int getNumCorruptBlocks() const noexcept
+    {
+        return numCorruptBlocks.load(std::memory_order_relaxed);
+    }
+    
+    // True after a prepareToPlay that could not get the memory for the
+    // delay histories. The input then passes through unchanged.
+    bool isOutOfMemory() const noexcept
+    {
+        return outOfMemory.load(std::memory_order_relaxed);
+    }
+    
+    // The rate the engines and their histories run at.
+    double getEngineSampleRate() const noexcept
+    {
+        return engineSampleRate;
+    }
+    
+    // Saves the last seconds of the delay history, the input and feedback
+    // going into the delay, as WAV or FLAC by the file's extension. The copy
+    // runs alongside processing and a background thread writes the file.
+    // Returns false while an earlier capture is still running.
+    static constexpr double maxCaptureSeconds = Parameters::maxDelayTime / 1000.0;
+    bool captureHistory(const juce::File& file, double seconds);
+    
+    // How far back a capture reaches right now. The history holds twice the
+    // delay time it is sized for, so it reaches further after a long delay.
+    double getMaxCaptureSeconds() const noexcept
+    {
+        return std::min(maxCaptureSeconds, 2.0 * historyTime.load(std::memory_order_relaxed) / 1000.0);
+    }
+    
+    bool isCapturingHistory() const noexcept
+    {
+        return historyCapture.isBusy();
+    }
+    
+    HistoryCapture::Result getLastCaptureResult() const noexcept
+    {
+        return historyCapture.getLastResult();
+    }
+    
+    // What goes into the delay history, reduced for the editor's display.
+    WaveformFeed& getWaveformFeed() noexcept
+    {
+        return waveformFeed;
+    }
+    
+    size_t getDelayMemoryBytes() const noexcept
+    {
+        return delayLine.getNumBytes() + dryDelayLine.getNumBytes() + multiLane.getNumBytes()
+             + reverseReverb.getNumBytes();
+    }
+    
+    // Stereo delay lanes on a main bus wider than stereo, one per channel
+    // pair. Zero with the usual stereo layout.
+    int getNumLanes() const noexcept
+    {
+        return multiLane.getNumLanes();
+    }
 private:
     
-    juce::dsp::StateVariableTPTFilter<float> lowCutFilter;
-    juce::dsp::StateVariableTPTFilter<float> highCutFilter;
+   #if DELAY_TRACING
+    // Set through the DELAY_TRACE_FILE environment variable. The capture
+    // runs while the instance exists and is written when it is destroyed.
+    juce::File traceFile;
+   #endif
+    
+    FeedbackFilter feedbackFilter;
+    DCBlocker dcBlocker;
+    
     
     
+    DelayBuffer delayLine;
+    HistoryCapture historyCapture;
+    WaveformFeed waveformFeed;
+    DelayBuffer dryDelayLine;
+    float dryDelay = 0.0f;
     
-    juce::dsp::DelayLine<float, juce::dsp::DelayLineInterpolationTypes::Linear> delayLine;
+    // A 60 s history takes about 46 MB at 48 kHz, so both histories are
+    // sized for the delay time in use, but never for less than the old 5 s
+    // maximum, and grow while playing when a longer delay comes along. The
+    // delay time is held at what they cover until they have grown.
+    static constexpr float minHistoryTime = 5000.0f;
+    std::atomic<float> historyTime { minHistoryTime };
+    float requestedHistoryTime = minHistoryTime;
+    int getWetHistoryLength(float delayTime) const noexcept;
+    int getDryHistoryLength(float delayTime) const noexcept;
+    void growHistories(float delayTime, int numSamples);
     
     float feedbackL = 0.0f;
     float feedbackR = 0.0f;
     
-    juce::AudioBuffer<float> reverseBuffer;
-    int reverseBufferIndex = 0;
+    const VectorKernels* kernels = &VectorKernels::get(VectorKernels::Isa::scalar);
+    std::optional<VectorKernels::Isa> forcedKernels;
+    
+    // Block-sized work space for the vectorised forward kernel.
+    enum ScratchChannel
+    {
+        wetLeft,
+        wetRight,
+        feedbackLeft,
+        feedbackRight,
+        inputLeft,
+        inputRight,
+        gainRamp,
+        mixRamp,
+        numScratchChannels,
+    };
+    juce::AudioBuffer<float> scratch;
+    
     bool reverseActive = false;
     
+    // How much of the wet signal comes from the reverse engine. Toggling
+    // Reverse moves this towards 0 or 1 one step per sample, and both
+    // engines run while it is in between.
+    float engineMix = 0.0f;
+    float engineFadeStep = 1.0f;
+    
+    bool isCrossfadingEngines() const noexcept
+    {
+        return engineMix != (reverseActive ? 1.0f : 0.0f);
+    }
+    
+    // 0 while the processor runs and 1 while it is bypassed. In between, the
+    // input into the engines fades out and the dry signal fades up to unity.
+    float bypassMix = 0.0f;
+    float bypassFadeStep = 1.0f;
+    bool bypassed = false;
+    static constexpr float bypassFadeTime = 20.0f;
+    
+    bool isFadingBypass() const noexcept
+    {
+        return bypassMix != (bypassed ? 1.0f : 0.0f);
+    }
+    
+    // Once the tail has stayed below the threshold for longer than any echo
+    // takes to come back, the engines are cleared and stop running.
+    static constexpr float tailThreshold = 1.0e-5f;
+    float tailPeak = 0.0f;
+    int tailSilence = 0;
+    bool tailIdle = false;
+    
+    void updateTail(float delayInSamples, int numSamples) noexcept;
+    
+    // One vector pass over the input before the engines and over their
+    // output after them. Only a block that fails pays for more than that.
+    void checkInput(float* channelDataL, float* channelDataR, int numSamples) noexcept;
+    void checkLoop(float* channelDataL, float* channelDataR, int numSamples) noexcept;
+    static void replaceNonFinite(float* data, int numSamples) noexcept;
+    
+    // After the loop has been cleared, the output fades back in from 0.
+    static constexpr float recoveryFadeTime = 10.0f;
+    float recoveryGain = 1.0f;
+    float recoveryStep = 1.0f;
+    std::atomic<int> numCorruptBlocks { 0 };
+    std::atomic<bool> outOfMemory { false };
+    
+    // Silences everything the engines still have in flight. Takes constant
+    // time, so it can run on the audio thread at any block.
+    void clearEngines() noexcept;
+    
+    // Whether the transport stopped or moved somewhere other than where the
+    // last block ended.
+    bool transportJumped(const juce::Optional<juce::AudioPlayHead::PositionInfo>& position, int numSamples) noexcept;
+    bool flushOnTransport = true;
+    bool wasTransportPlaying = false;
+    juce::int64 nextTransportTime = -1;
+    void processIdle(float* channelDataL, float* channelDataR, int numSamples, bool dryInOutput) noexcept;
+    void publishWaveform(float delayInSamples, int numSamples) noexcept;
+    
+    // A head that is cut off at a boundary, or runs out before it, keeps
+    // going and fades out over this time instead of stopping dead.
+    static constexpr float reverseFadeTime = 5.0f;
+    int reverseFadeLength = 1;
+    
     Tempo tempo;
     
+    // The spectral history grows with the segment length much faster than
+    // the sample buffers, so it stops at the old maximum delay. Longer
+    // segments are clamped by SpectralReverse.
+    static constexpr float maxSpectralSegmentTime = 5000.0f;
+    
+    // Onset mode cuts a segment at every transient, but never shorter than this.
+    static constexpr float minSegmentTime = 50.0f;
+    OnsetDetector onsetDetector;
+    
+    SpectralReverse spectralReverse;
+    bool prevSpectralActive = false;
+    
+    void updateLatency(float delayTime);
+    
+    // The longer of the delay time being played and the one it glides to,
+    // kept for getTailLengthSeconds on the message thread.
+    std::atomic<float> tailDelayTime { 0.0f };
+    
+    Pipeline pipeline;
+    
+    // Everything the host asks for goes through here, and from here either
+    // straight to the engines or through the pipeline, which calls them
+    // from its worker.
+    void processHostBlock(juce::AudioBuffer<float>& buffer, bool hostBypass);
+    void processEngines(juce::AudioBuffer<float>& buffer, const Pipeline::Position& position, bool hostBypass);
+    
+    // The optional output buses after the main one carry the dry signal and
+    // the wet signal of each engine, for mixing and processing elsewhere.
+    enum Stem
+    {
+        dryStem,
+        forwardStem,
+        reverseStem,
+        numStems,
+    };
+    
+    // Per-block values shared by all kernels that process the block.
+    struct BlockContext
+    {
+        std::array<float*, numStems> stemLeft {};
+        std::array<float*, numStems> stemRight {};
+        bool stemsActive = false;
+
+        float syncedTime = 0.0f;
+        float sampleRate = 44100.0f;
+        int minSegmentLength = 0;
+        int numOnsets = 0;
+        int nextOnset = 0;
+        bool spectralActive = false;
+        
+        // False at the reduced rate, where the kernels produce only the wet
+        // signal and the dry signal is mixed in at the full rate.
+        bool dryInOutput = true;
+    };
+    
+    void processCore(float* channelDataL, float* channelDataR, int numSamples, BlockContext& context) noexcept;
+    
+    // With more than two main channels, every pair is a lane of the forward
+    // engine, driven by the parameters and its own LaneSettings. Reverse,
+    // lookahead, the stems and the decimated path do not apply, and neither
+    // do the filters: they sit inside the feedback loop, which the lanes
+    // kernel runs for every voice at once, one sample at a time.
+    void processLanes(juce::AudioBuffer<float>& buffer, float syncedTime) noexcept;
+    MultiLaneDelay multiLane;
+    std::array<LaneSettings, MultiLaneDelay::maxLanes> laneSettings;
+    
+    // Each lane keeps a history of every channel in its own row, so the
+    // lanes stop at the old maximum delay, like the spectral history.
+    static constexpr float maxLaneDelayTime = 5000.0f;
+    
+    // While Reverse Reverb is on, the reverb takes the place of the engines.
+    // Switching crossfades between the two over the reverse fade time, at
+    // the host rate, and the engines only run while they can be heard.
+    void processReverb(juce::AudioBuffer<float>& buffer, BlockContext& hostContext, bool reverbActive) noexcept;
+    ReverseReverb reverseReverb;
+    float reverbMix = 0.0f;
+    float lastReverbGain = 0.0f;
+    bool enginesCleared = false;
+    
+    enum ReverbChannel
+    {
+        reverbLeft,
+        reverbRight,
+        reverbDryLeft,
+        reverbDryRight,
+        reverbFade,
+        reverbRamp,
+        numReverbChannels,
+    };
+    juce::AudioBuffer<float> reverbBuffer;
+    
+    // A straight line that ends at end after numSamples steps.
+    static void fillRamp(float* ramp, float start, float end, int numSamples) noexcept;
+    void processDecimated(juce::AudioBuffer<float>& buffer, BlockContext& hostContext) noexcept;
+    
+    static int chooseDecimation(double sampleRate) noexcept;
+    
+    int decimation = 1;
+    double engineSampleRate = 0.0;
+    int resamplerLatency = 0;
+    HalfBandResampler decimator;
+    
+    // The wet signal in the slot of the dry stem, then the engine stems.
+    std::array<HalfBandResampler, numStems> interpolators;
+    juce::AudioBuffer<float> reduced;
+    
+    // The dry and stem gains at the end of the last block. They ramp to the
+    // new values across each block at the full rate.
+    float lastDryGain = 1.0f;
+    float lastStemGain = 1.0f;
+    
+    enum class MixMode
+    {
+        blend,
+        wet,
+        dry,
+    };
+    
+    // Sub-block length while parameters are ramping, after which the
+    // processor checks whether it can switch to a settled kernel.
+    static constexpr int rampSubBlockSize = 32;
+    bool filtersRunning = false;
+    
+    using Kernel = void (DelayAudioProcessor::*)(float*, float*, int, int, BlockContext&) noexcept;
+    
+    template<bool Reverse, bool Ramping, bool Feedback, bool Filters, MixMode Mix>
+    void processKernel(float* channelDataL, float* channelDataR,
+                       int startSample, int endSample, BlockContext& context) noexcept;
+    
+    template<bool Feedback, bool Filters, bool RampedOutput>
+    void processForwardBlock(float* channelDataL, float* channelDataR,
+                             int startSample, int endSample, BlockContext& context) noexcept;
+    
+    static Kernel selectRampedOutputKernel(bool feedback, bool filters) noexcept;
+    
+    void processForwardTail(float* channelDataL, float* channelDataR,
+                            int startSample, int endSample, BlockContext& context) noexcept;
+    
+    template<bool Reverse>
+    static Kernel selectSettledKernel(bool feedback, bool filters, MixMode mix) noexcept;
+    
+    template<bool Reverse, bool Feedback, bool Filters>
+    static Kernel selectMixKernel(MixMode mix) noexcept;
+    
+    void processReverseSample(float inputL, float inputR, float delayInSamples, int sample,
+                              BlockContext& context, float& wetL, float& wetR) noexcept;
+    void queueReverseHead(const ReverseHead& head) noexcept;
+    void fadeOutReverseHead(float delay) noexcept;
+    void crossfadeEngines(float inputL, float inputR, float delayInSamples, int sample,
+                          BlockContext& context, float& wetL, float& wetR) noexcept;
+    void writeStem(BlockContext& context, Stem stem, int sample, float left, float right) const noexcept;
+    
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DelayAudioProcessor)
 };
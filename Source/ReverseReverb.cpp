@@ -0,0 +1,517 @@
+/*
+  ==============================================================================
+
+    ReverseReverb.cpp
+    Created: 19 Oct 2026 9:53:16pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "ReverseReverb.h"
+#include "Trace.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+#endif
+
+// Scales the impulse to unit energy in its louder channel, so noise comes
+// out as loud as it went in, however long the impulse is.
+static void normalise(juce::AudioBuffer<float>& impulse)
+{
+    double energy = 0.0;
+    for (int channel = 0; channel < impulse.getNumChannels(); ++channel)
+    {
+        const float* data = impulse.getReadPointer(channel);
+        double sum = 0.0;
+        for (int i = 0; i < impulse.getNumSamples(); ++i)
+        {
+            sum += double(data[i]) * double(data[i]);
+        }
+        energy = std::max(energy, sum);
+    }
+
+    if (energy > 0.0)
+    {
+        impulse.applyGain(float(1.0 / std::sqrt(energy)));
+    }
+}
+
+// The FFT writes bin after bin with the real and imaginary parts side by
+// side. Keeping them in separate runs lets the complex multiplication below
+// run as plain vector arithmetic.
+static void splitSpectrum(const float* interleaved, float* spectrum, int numBins) noexcept
+{
+    float* re = spectrum;
+    float* im = spectrum + numBins;
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        re[bin] = interleaved[2 * bin];
+        im[bin] = interleaved[2 * bin + 1];
+    }
+}
+
+static void interleaveSpectrum(const float* spectrum, float* interleaved, int numBins) noexcept
+{
+    const float* re = spectrum;
+    const float* im = spectrum + numBins;
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        interleaved[2 * bin] = re[bin];
+        interleaved[2 * bin + 1] = im[bin];
+    }
+}
+
+static void multiplyAdd(float* accumulator, const float* input, const float* impulse, int numBins) noexcept
+{
+    float* accRe = accumulator;
+    float* accIm = accumulator + numBins;
+    const float* xRe = input;
+    const float* xIm = input + numBins;
+    const float* hRe = impulse;
+    const float* hIm = impulse + numBins;
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        accRe[bin] += xRe[bin] * hRe[bin] - xIm[bin] * hIm[bin];
+        accIm[bin] += xRe[bin] * hIm[bin] + xIm[bin] * hRe[bin];
+    }
+}
+
+//==============================================================================
+void ReverseReverb::Stage::prepare(const juce::AudioBuffer<float>& impulse, int offset, int size_, int numPartitions_)
+{
+    size = size_;
+    numPartitions = numPartitions_;
+    numBins = size + 1;
+
+    // Twice the partition size, so the circular convolution of a window of
+    // two blocks holds the linear convolution of the newer one in its second
+    // half.
+    int order = 1;
+    while ((1 << order) < 2 * size)
+    {
+        ++order;
+    }
+    fft = std::make_unique<juce::dsp::FFT>(order);
+    fftData.assign(size_t(4 * size), 0.0f);
+
+    size_t spectraSize = size_t(numPartitions * 2 * 2 * numBins);
+    impulseSpectra.assign(spectraSize, 0.0f);
+    inputSpectra.assign(spectraSize, 0.0f);
+    accumulator.assign(size_t(2 * numBins), 0.0f);
+
+    for (int partition = 0; partition < numPartitions; ++partition)
+    {
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            int source = std::min(channel, impulse.getNumChannels() - 1);
+            int start = offset + partition * size;
+            int count = std::min(size, impulse.getNumSamples() - start);
+
+            std::fill(fftData.begin(), fftData.end(), 0.0f);
+            if (count > 0)
+            {
+                std::copy_n(impulse.getReadPointer(source, start), count, fftData.begin());
+            }
+            fft->performRealOnlyForwardTransform(fftData.data(), true);
+            splitSpectrum(fftData.data(), getSpectrum(impulseSpectra, partition, channel), numBins);
+        }
+    }
+
+    block.setSize(2, size);
+    window.setSize(2, 2 * size);
+    for (auto& result : results)
+    {
+        result.setSize(2, size);
+    }
+    numLaunched.store(0);
+    numComputed.store(0);
+    reset();
+}
+
+void ReverseReverb::Stage::reset() noexcept
+{
+    block.clear();
+    window.clear();
+    for (auto& result : results)
+    {
+        result.clear();
+    }
+    current = 0;
+    position = 0;
+    inputIndex = 0;
+    numValid = 0;
+}
+
+size_t ReverseReverb::Stage::getNumBytes() const noexcept
+{
+    size_t numFloats = fftData.size() + impulseSpectra.size() + inputSpectra.size() + accumulator.size()
+                     + size_t(2 * size) * 6;
+    return numFloats * sizeof(float);
+}
+
+bool ReverseReverb::Stage::push(const float* inputL, const float* inputR, int frameSize) noexcept
+{
+    jassert(position + frameSize <= size);
+    block.copyFrom(0, position, inputL, frameSize);
+    block.copyFrom(1, position, inputR, frameSize);
+    position += frameSize;
+    return position == size;
+}
+
+void ReverseReverb::Stage::read(float* outputL, float* outputR, int frameSize) noexcept
+{
+    // The head reads the block it has just computed, the other stages the
+    // part of the current result that lines up with the frame being pushed.
+    int start = immediate ? 0 : position;
+    juce::FloatVectorOperations::add(outputL, results[size_t(current)].getReadPointer(0, start), frameSize);
+    juce::FloatVectorOperations::add(outputR, results[size_t(current)].getReadPointer(1, start), frameSize);
+}
+
+void ReverseReverb::Stage::launch() noexcept
+{
+    // The other result was computed from the block before, and is due from
+    // the next frame on.
+    if (!immediate)
+    {
+        current = 1 - current;
+    }
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        float* data = window.getWritePointer(channel);
+        std::copy_n(data + size, size, data);
+        std::copy_n(block.getReadPointer(channel), size, data + size);
+    }
+    position = 0;
+    numLaunched.fetch_add(1);
+}
+
+void ReverseReverb::Stage::compute() noexcept
+{
+    auto& result = results[size_t(immediate ? current : 1 - current)];
+
+    inputIndex = inputIndex + 1 == numPartitions ? 0 : inputIndex + 1;
+    numValid = std::min(numValid + 1, numPartitions);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        std::copy_n(window.getReadPointer(channel), 2 * size, fftData.begin());
+        std::fill(fftData.begin() + 2 * size, fftData.end(), 0.0f);
+        fft->performRealOnlyForwardTransform(fftData.data(), true);
+        splitSpectrum(fftData.data(), getSpectrum(inputSpectra, inputIndex, channel), numBins);
+
+        // Partition p meets the input from p blocks ago.
+        std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+        for (int partition = 0; partition < numValid; ++partition)
+        {
+            int slot = inputIndex - partition;
+            slot += slot < 0 ? numPartitions : 0;
+            multiplyAdd(accumulator.data(), getSpectrum(inputSpectra, slot, channel),
+                        getSpectrum(impulseSpectra, partition, channel), numBins);
+        }
+
+        interleaveSpectrum(accumulator.data(), fftData.data(), numBins);
+        std::fill(fftData.begin() + 2 * numBins, fftData.end(), 0.0f);
+        fft->performRealOnlyInverseTransform(fftData.data());
+        std::copy_n(fftData.begin() + size, size, result.getWritePointer(channel));
+    }
+}
+
+//==============================================================================
+class ReverseReverb::Worker : public juce::Thread
+{
+public:
+    explicit Worker(ReverseReverb& owner_)
+        : juce::Thread("Delay reverb"), owner(owner_)
+    {
+    }
+
+    void run() override
+    {
+        juce::ScopedNoDenormals noDenormals;
+        while (!threadShouldExit())
+        {
+            bool worked = false;
+            for (auto& stage : owner.stages)
+            {
+                if (stage->onWorker && isPending(*stage))
+                {
+                    DELAY_TRACE_ZONE("reverb partition");
+                    stage->compute();
+                    stage->numComputed.fetch_add(1);
+                    worked = true;
+                }
+            }
+            if (worked)
+            {
+                continue;
+            }
+
+            // As in the pipeline, the flag goes up before the last look and
+            // the audio thread launches before it checks the flag.
+            owner.workerParked.store(true);
+            if (!hasWork())
+            {
+                owner.wakeUp.wait(100.0);
+            }
+            owner.workerParked.store(false);
+        }
+    }
+
+    static bool isPending(const Stage& stage) noexcept
+    {
+        return stage.numComputed.load(std::memory_order_relaxed) != stage.numLaunched.load();
+    }
+
+private:
+    bool hasWork() const noexcept
+    {
+        for (auto& stage : owner.stages)
+        {
+            if (stage->onWorker && isPending(*stage))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    ReverseReverb& owner;
+};
+
+//==============================================================================
+ReverseReverb::ReverseReverb() = default;
+
+ReverseReverb::~ReverseReverb()
+{
+    release();
+}
+
+void ReverseReverb::prepare(const juce::AudioBuffer<float>& impulse, const Options& options)
+{
+    release();
+
+    // Each stage ends where the next one starts, at twice the next size,
+    // and the last one runs to the end of the impulse.
+    impulseLength = impulse.getNumSamples();
+    int offset = 0;
+    int size = headSize;
+    while (offset < impulseLength)
+    {
+        int nextSize = std::min(size * 8, largestPartition);
+        int end = nextSize == size ? impulseLength : std::min(impulseLength, 2 * nextSize);
+        int numPartitions = (end - offset + size - 1) / size;
+
+        auto& stage = stages.emplace_back(std::make_unique<Stage>());
+        stage->immediate = size == headSize;
+        stage->onWorker = options.useWorker && size >= workerPartition;
+        stage->prepare(impulse, offset, size, numPartitions);
+
+        offset += numPartitions * size;
+        size = nextSize;
+    }
+
+    frameInput.setSize(2, headSize);
+    frameOutput.setSize(2, headSize);
+    frameInput.clear();
+    frameOutput.clear();
+    framePosition = 0;
+
+    bool needsWorker = std::any_of(stages.begin(), stages.end(), [](const auto& stage) { return stage->onWorker; });
+    if (needsWorker)
+    {
+        workerParked.store(false);
+        wakeUp.reset();
+        worker = std::make_unique<Worker>(*this);
+        worker->startThread(juce::Thread::Priority::high);
+    }
+}
+
+void ReverseReverb::release()
+{
+    if (worker != nullptr)
+    {
+        worker->signalThreadShouldExit();
+        wakeUp.signal();
+        worker->stopThread(1000);
+        worker.reset();
+    }
+    stages.clear();
+    impulseLength = 0;
+}
+
+void ReverseReverb::reset() noexcept
+{
+    for (auto& stage : stages)
+    {
+        if (stage->onWorker)
+        {
+            waitForWorker(*stage);
+        }
+        stage->reset();
+    }
+    frameInput.clear();
+    frameOutput.clear();
+    framePosition = 0;
+}
+
+size_t ReverseReverb::getNumBytes() const noexcept
+{
+    size_t numBytes = 0;
+    for (auto& stage : stages)
+    {
+        numBytes += stage->getNumBytes();
+    }
+    return numBytes;
+}
+
+void ReverseReverb::waitForWorker(Stage& stage) noexcept
+{
+    // The worker has a whole block of the stage to finish, so this only
+    // spins when the machine is badly overloaded.
+    for (int i = 0; Worker::isPending(stage); ++i)
+    {
+        if (i < 4096)
+        {
+           #if JUCE_INTEL
+            _mm_pause();
+           #endif
+        }
+        else
+        {
+            juce::Thread::yield();
+        }
+    }
+}
+
+void ReverseReverb::process(const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples) noexcept
+{
+    // Frames of headSize samples go in and come out one frame later, which
+    // is the whole latency whatever the block size.
+    int done = 0;
+    while (done < numSamples)
+    {
+        int count = std::min(numSamples - done, headSize - framePosition);
+        frameInput.copyFrom(0, framePosition, inputL + done, count);
+        frameInput.copyFrom(1, framePosition, inputR + done, count);
+        std::copy_n(frameOutput.getReadPointer(0, framePosition), count, outputL + done);
+        std::copy_n(frameOutput.getReadPointer(1, framePosition), count, outputR + done);
+
+        framePosition += count;
+        done += count;
+        if (framePosition == headSize)
+        {
+            processFrame();
+            framePosition = 0;
+        }
+    }
+}
+
+void ReverseReverb::processFrame() noexcept
+{
+    const float* inputL = frameInput.getReadPointer(0);
+    const float* inputR = frameInput.getReadPointer(1);
+    float* outputL = frameOutput.getWritePointer(0);
+    float* outputR = frameOutput.getWritePointer(1);
+    frameOutput.clear();
+
+    for (auto& stage : stages)
+    {
+        if (stage->immediate)
+        {
+            stage->push(inputL, inputR, headSize);
+            stage->launch();
+            stage->compute();
+            stage->read(outputL, outputR, headSize);
+            continue;
+        }
+
+        // The share of this frame comes from the result that is current
+        // before the block completes.
+        stage->read(outputL, outputR, headSize);
+        if (!stage->push(inputL, inputR, headSize))
+        {
+            continue;
+        }
+
+        if (stage->onWorker)
+        {
+            waitForWorker(*stage);
+            stage->launch();
+            if (workerParked.load())
+            {
+                wakeUp.signal();
+            }
+        }
+        else
+        {
+            DELAY_TRACE_ZONE("reverb partition");
+            stage->launch();
+            stage->compute();
+        }
+    }
+}
+
+//==============================================================================
+juce::AudioBuffer<float> ReverseReverb::createImpulse(double sampleRate, double seconds)
+{
+    int length = std::max(1, int(seconds * sampleRate));
+    juce::AudioBuffer<float> impulse(2, length);
+
+    // Fixed seeds, so the same length always sounds the same. Each channel
+    // gets its own noise, which keeps the swell wide.
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        juce::Random random(channel + 1);
+        float* data = impulse.getWritePointer(channel);
+        for (int i = 0; i < length; ++i)
+        {
+            float decay = std::exp(-6.9077553f * float(i) / float(length));
+            data[length - 1 - i] = (random.nextFloat() * 2.0f - 1.0f) * decay;
+        }
+    }
+
+    normalise(impulse);
+    return impulse;
+}
+
+juce::AudioBuffer<float> ReverseReverb::loadImpulse(const juce::File& file, double sampleRate, double maxSeconds)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+    {
+        return {};
+    }
+
+    int numChannels = std::min(2, int(reader->numChannels));
+    auto maxLength = juce::int64(std::ceil(maxSeconds * reader->sampleRate));
+    int sourceLength = int(std::min(reader->lengthInSamples, maxLength));
+    juce::AudioBuffer<float> source(numChannels, sourceLength);
+    reader->read(&source, 0, sourceLength, 0, true, numChannels > 1);
+
+    // Linear interpolation is good enough for the noise-like body of a
+    // reverb, which is all that is left once it is reversed.
+    double ratio = reader->sampleRate / sampleRate;
+    int length = std::max(1, int(double(sourceLength) / ratio));
+    juce::AudioBuffer<float> impulse(numChannels, length);
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const float* in = source.getReadPointer(channel);
+        float* out = impulse.getWritePointer(channel);
+        for (int i = 0; i < length; ++i)
+        {
+            double position = double(i) * ratio;
+            int index = std::min(int(position), sourceLength - 1);
+            int next = std::min(index + 1, sourceLength - 1);
+            float fraction = float(position - double(index));
+            out[i] = in[index] + fraction * (in[next] - in[index]);
+        }
+    }
+
+    impulse.reverse(0, length);
+    normalise(impulse);
+    return impulse;
+}
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+
+    ReverseReverb.h
+    Created: 19 Oct 2026 9:53:16pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Convolves a stereo signal with a reversed reverb impulse, so every sound
+// swells up into the moment the impulse is cut off, the way a reverb that
+// was printed, reversed and recorded back would.
+//
+// The impulse is split into partitions of growing size. The first part uses
+// short partitions, which fix the latency at headSize samples, and every
+// stage after that uses partitions eight times longer, up to
+// largestPartition. Each stage is a uniformly partitioned convolution in the
+// frequency domain, with the spectra of its partitions and of the past input
+// allocated in prepare.
+//
+// A stage of size S starts 2 S into the impulse, so its result for a block
+// of input is not due until one block after that block is complete. The
+// largest stage can therefore run on a worker thread, which spreads its FFTs
+// over that block instead of putting all of them into the block in which the
+// input completes. The audio thread only waits if the worker is late.
+class ReverseReverb
+{
+public:
+    struct Options
+    {
+        // Computes the stages with the largest partitions on a worker thread.
+        bool useWorker = true;
+    };
+
+    ReverseReverb();
+    ~ReverseReverb();
+
+    // Audio must be stopped. The impulse has one or two channels and is
+    // used as it is, so it should already be reversed.
+    void prepare(const juce::AudioBuffer<float>& impulse, const Options& options);
+
+    // Stops the worker and frees the memory. Audio must be stopped.
+    void release();
+
+    // Audio thread. Silences the input in flight without touching most of
+    // the stored spectra.
+    void reset() noexcept;
+
+    static constexpr int headSize = 128;
+    static constexpr int largestPartition = 8192;
+
+    int getLatency() const noexcept
+    {
+        return headSize;
+    }
+
+    int getImpulseLength() const noexcept
+    {
+        return impulseLength;
+    }
+
+    size_t getNumBytes() const noexcept;
+
+    // Audio thread. Never allocates. output may be the same as input.
+    void process(const float* inputL, const float* inputR, float* outputL, float* outputR, int numSamples) noexcept;
+
+    // Stereo noise that decays by 60 dB over its length, reversed.
+    static juce::AudioBuffer<float> createImpulse(double sampleRate, double seconds);
+
+    // Reads a reverb impulse from an audio file, converts it to the sample
+    // rate, cuts it off after maxSeconds and reverses it. Empty if the file
+    // cannot be read.
+    static juce::AudioBuffer<float> loadImpulse(const juce::File& file, double sampleRate, double maxSeconds);
+
+private:
+    class Stage
+    {
+    public:
+        // Covers numPartitions partitions of size samples of the impulse,
+        // starting at offset.
+        void prepare(const juce::AudioBuffer<float>& impulse, int offset, int size, int numPartitions);
+        void reset() noexcept;
+
+        int getSize() const noexcept
+        {
+            return size;
+        }
+
+        size_t getNumBytes() const noexcept;
+
+        // Audio thread. Adds one frame of input and returns true once that
+        // completes a block, which then has to be launched.
+        bool push(const float* inputL, const float* inputR, int frameSize) noexcept;
+
+        // Audio thread. Adds the stage's share of the output for the next
+        // frame.
+        void read(float* outputL, float* outputR, int frameSize) noexcept;
+
+        // Audio thread. Makes the result of the last block current and
+        // hands the block that was just completed to compute.
+        void launch() noexcept;
+
+        // Any thread, one call per launch. Convolves the block handed over
+        // by launch and writes the result that becomes current next time.
+        void compute() noexcept;
+
+        // The head computes each block as soon as it is complete and
+        // outputs the result straight away.
+        bool immediate = false;
+        bool onWorker = false;
+
+        // Launches and computes, counted so the audio thread can tell when
+        // the worker is done with a block.
+        std::atomic<juce::int64> numLaunched { 0 };
+        std::atomic<juce::int64> numComputed { 0 };
+
+    private:
+        int size = 0;
+        int numPartitions = 0;
+        int numBins = 0;
+        std::unique_ptr<juce::dsp::FFT> fft;
+        std::vector<float> fftData;
+
+        // Spectra with the real parts of all bins followed by the imaginary
+        // parts, one per partition and channel, and the same for the input
+        // of past blocks, newest at inputIndex.
+        std::vector<float> impulseSpectra;
+        std::vector<float> inputSpectra;
+        std::vector<float> accumulator;
+        int inputIndex = 0;
+
+        // Past blocks that hold input since the last reset. Older spectra
+        // are skipped, which is what makes a reset cheap.
+        int numValid = 0;
+
+        float* getSpectrum(std::vector<float>& spectra, int partition, int channel) noexcept
+        {
+            return spectra.data() + size_t((partition * 2 + channel) * 2 * numBins);
+        }
+
+        // The block being filled, the last two complete blocks for compute,
+        // and the results of the last two launches.
+        juce::AudioBuffer<float> block;
+        juce::AudioBuffer<float> window;
+        std::array<juce::AudioBuffer<float>, 2> results;
+        int current = 0;
+        int position = 0;
+    };
+
+    class Worker;
+
+    // Audio thread. Runs one frame of headSize samples through all stages.
+    void processFrame() noexcept;
+    void waitForWorker(Stage& stage) noexcept;
+
+    std::vector<std::unique_ptr<Stage>> stages;
+    int impulseLength = 0;
+
+    // Stages from this size up go to the worker when it runs.
+    static constexpr int workerPartition = largestPartition;
+
+    juce::AudioBuffer<float> frameInput;
+    juce::AudioBuffer<float> frameOutput;
+    int framePosition = 0;
+
+    // Set when the worker has nothing to do and sleeps on the event.
+    std::atomic<bool> workerParked { false };
+    juce::WaitableEvent wakeUp;
+    std::unique_ptr<Worker> worker;
+
+    JUCE_DECLARE_NON_COPYABLE(ReverseReverb)
+};
@@ -33,7 +33,7 @@ RotaryKnob::RotaryKnob(const juce::String& text,
     label.attachToComponent(&slider, false);
     addAndMakeVisible(label);
     
-    setLookAndFeel(RotaryKnobLookAndFeel::get());
+    setLookAndFeel(&resources->rotaryKnobLookAndFeel);
     
     
     
@@ -45,6 +45,8 @@ RotaryKnob::RotaryKnob(const juce::String& text,
 
 RotaryKnob::~RotaryKnob()
 {
+    // The look and feel may go away with the resources right after this.
+    setLookAndFeel(nullptr);
 }
 
 
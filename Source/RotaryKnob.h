@@ -11,6 +11,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "LookAndFeel.h"
 
 //==============================================================================
 /*
@@ -33,5 +34,7 @@ public:
     juce::AudioProcessorValueTreeState::SliderAttachment attachment;
 
 private:
+    juce::SharedResourcePointer<UIResources> resources;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RotaryKnob)
 };
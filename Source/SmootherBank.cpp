@@ -0,0 +1,133 @@
+/*
+  ==============================================================================
+
+    SmootherBank.cpp
+    Created: 19 Oct 2026 4:52:40pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "SmootherBank.h"
+
+void SmootherBank::setCurve(int index, Curve curve, double newSeconds) noexcept
+{
+    curves[size_t(index)] = curve;
+    seconds[size_t(index)] = newSeconds;
+}
+
+void SmootherBank::prepare(double sampleRate) noexcept
+{
+    for (int i = 0; i < maxSmoothers; ++i)
+    {
+        double numSamples = seconds[size_t(i)] * sampleRate;
+        rampLength[size_t(i)] = int(std::floor(numSamples));
+        onePoleCoeff[size_t(i)] = numSamples > 0.0 ? 1.0f - std::exp(-1.0f / float(numSamples)) : 1.0f;
+        snap(i, target[size_t(i)]);
+    }
+    updateMaxRemaining();
+}
+
+void SmootherBank::snap(int index, float value) noexcept
+{
+    auto i = size_t(index);
+    current[i] = value;
+    target[i] = value;
+    multiplier[i] = 1.0f;
+    increment[i] = 0.0f;
+    remaining[i] = 0;
+}
+
+void SmootherBank::updateMaxRemaining() noexcept
+{
+    maxRemaining = *std::max_element(remaining.begin(), remaining.end());
+}
+
+void SmootherBank::setCurrentAndTarget(int index, float value) noexcept
+{
+    snap(index, value);
+    updateMaxRemaining();
+}
+
+void SmootherBank::setTarget(int index, float newTarget) noexcept
+{
+    auto i = size_t(index);
+    if (newTarget == target[i])
+    {
+        return;
+    }
+
+    float distance = newTarget - current[i];
+    int steps = rampLength[i];
+
+    switch (curves[i])
+    {
+        case Curve::linear:
+            multiplier[i] = 1.0f;
+            increment[i] = steps > 0 ? distance / float(steps) : 0.0f;
+            break;
+
+        case Curve::multiplicative:
+            jassert(newTarget > 0.0f && current[i] > 0.0f);
+            multiplier[i] = steps > 0 ? float(std::pow(double(newTarget) / double(current[i]), 1.0 / steps)) : 1.0f;
+            increment[i] = 0.0f;
+            break;
+
+        case Curve::onePole:
+        {
+            // How long the exponential takes to get within the tolerance.
+            float coeff = onePoleCoeff[i];
+            multiplier[i] = 1.0f - coeff;
+            increment[i] = newTarget * coeff;
+            steps = std::abs(distance) > onePoleTolerance
+                  ? int(std::ceil(std::log(onePoleTolerance / std::abs(distance)) / std::log(1.0f - coeff)))
+                  : 0;
+            break;
+        }
+    }
+
+    if (steps <= 0)
+    {
+        snap(index, newTarget);
+    }
+    else
+    {
+        target[i] = newTarget;
+        remaining[i] = steps;
+    }
+    updateMaxRemaining();
+}
+
+void SmootherBank::render(float* const* destinations, int numSamples) noexcept
+{
+    for (size_t i = 0; i < size_t(maxSmoothers); ++i)
+    {
+        float* dest = destinations[i];
+        float value = current[i];
+        int rampSamples = std::min(numSamples, remaining[i] - 1);
+        int sample = 0;
+
+        // The same steps as next(), one lane at a time.
+        for (; sample < rampSamples; ++sample)
+        {
+            value = value * multiplier[i] + increment[i];
+            if (dest != nullptr)
+            {
+                dest[sample] = value;
+            }
+        }
+
+        if (remaining[i] > 0 && remaining[i] <= numSamples)
+        {
+            value = target[i];
+        }
+        if (dest != nullptr)
+        {
+            std::fill(dest + sample, dest + numSamples, value);
+        }
+
+        current[i] = value;
+        remaining[i] = std::max(remaining[i] - numSamples, 0);
+    }
+    maxRemaining = std::max(maxRemaining - numSamples, 0);
+}
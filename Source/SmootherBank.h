@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    SmootherBank.h
+    Created: 19 Oct 2026 4:52:40pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// All parameter smoothers in one structure of arrays. Every curve is written
+// as value = value * multiplier + increment, so a single loop over the lanes
+// advances all of them at once and the compiler turns it into a few vector
+// instructions. Adding a smoother fills another lane and costs nothing per
+// sample until the lanes run out.
+class SmootherBank
+{
+public:
+    static constexpr int maxSmoothers = 8;
+
+    enum class Curve
+    {
+        // Straight line, for percentages.
+        linear,
+        // Straight line on a log scale, for Hz and gain. Values must be above zero.
+        multiplicative,
+        // Exponential approach with the given time constant, for delay times.
+        onePole,
+    };
+
+    // Sets up a lane. For the one-pole curve, seconds is the time constant,
+    // otherwise it is the ramp length.
+    void setCurve(int index, Curve curve, double seconds) noexcept;
+    void prepare(double sampleRate) noexcept;
+
+    void setTarget(int index, float newTarget) noexcept;
+    void setCurrentAndTarget(int index, float value) noexcept;
+
+    // Advances all lanes by one sample.
+    void next() noexcept
+    {
+        if (maxRemaining == 0)
+        {
+            return;
+        }
+
+        for (int i = 0; i < maxSmoothers; ++i)
+        {
+            float stepped = current[i] * multiplier[i] + increment[i];
+            current[i] = remaining[i] > 1 ? stepped : remaining[i] == 1 ? target[i] : current[i];
+            remaining[i] = std::max(remaining[i] - 1, 0);
+        }
+        --maxRemaining;
+    }
+
+    // Advances all lanes by numSamples and writes the values of each lane
+    // into destinations[lane], unless that is nullptr. Gives exactly the
+    // values that calling next() numSamples times would.
+    void render(float* const* destinations, int numSamples) noexcept;
+
+    float getCurrentValue(int index) const noexcept
+    {
+        return current[size_t(index)];
+    }
+
+    float getTargetValue(int index) const noexcept
+    {
+        return target[size_t(index)];
+    }
+
+    bool isSmoothing(int index) const noexcept
+    {
+        return remaining[size_t(index)] > 0;
+    }
+
+    // True once every lane has reached its target.
+    bool isSettled() const noexcept
+    {
+        return maxRemaining == 0;
+    }
+
+private:
+    void snap(int index, float value) noexcept;
+    void updateMaxRemaining() noexcept;
+
+    // A one-pole lane snaps to its target once it is this close.
+    static constexpr float onePoleTolerance = 0.001f;
+
+    alignas(32) std::array<float, maxSmoothers> current {};
+    alignas(32) std::array<float, maxSmoothers> target {};
+    alignas(32) std::array<float, maxSmoothers> multiplier {};
+    alignas(32) std::array<float, maxSmoothers> increment {};
+    alignas(32) std::array<int, maxSmoothers> remaining {};
+
+    std::array<Curve, maxSmoothers> curves {};
+    std::array<double, maxSmoothers> seconds {};
+    std::array<int, maxSmoothers> rampLength {};
+    std::array<float, maxSmoothers> onePoleCoeff {};
+
+    int maxRemaining = 0;
+};
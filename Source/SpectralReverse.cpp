@@ -0,0 +1,377 @@
+/*
+  ==============================================================================
+
+    SpectralReverse.cpp
+    Created: 19 Oct 2026 1:26:09pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "SpectralReverse.h"
+
+static float wrapPhase(float phase) noexcept
+{
+    constexpr float twoPi = juce::MathConstants<float>::twoPi;
+    return phase - twoPi * std::round(phase / twoPi);
+}
+
+SpectralReverse::GrowThread::GrowThread()
+    : juce::TimeSliceThread("Spectral ring")
+{
+    startThread(juce::Thread::Priority::background);
+}
+
+SpectralReverse::GrowThread::~GrowThread()
+{
+    stopThread(5000);
+}
+
+SpectralReverse::Ring::Ring(int frames, int numBins)
+    : numFrames(frames)
+{
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        magnitudes[size_t(channel)].resize(size_t(numFrames * numBins));
+        phaseAdvances[size_t(channel)].resize(size_t(numFrames * numBins));
+    }
+}
+
+SpectralReverse::SpectralReverse()
+{
+    growThread->addTimeSliceClient(this);
+}
+
+SpectralReverse::~SpectralReverse()
+{
+    // Waits for a ring being grown.
+    growThread->removeTimeSliceClient(this);
+
+    delete grown.exchange(nullptr);
+    delete retired.exchange(nullptr);
+}
+
+void SpectralReverse::prepare(int maxSegmentLength, const Options& options)
+{
+    // The audio thread is stopped, but the background thread may be growing
+    // a ring with the old sizes.
+    const juce::ScopedLock sl(growLock);
+
+    fft = std::make_unique<juce::dsp::FFT>(options.fftOrder);
+    fftSize = fft->getSize();
+    hopSize = juce::jlimit(1, fftSize, options.hopSize);
+    numBins = fftSize / 2 + 1;
+    fifoSize = fftSize + hopSize;
+
+    window.resize(size_t(fftSize));
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), size_t(fftSize), options.window, false);
+
+    // Analysis and synthesis both apply the window, so overlap-add sums the
+    // squared window. This scales the result back to unity gain.
+    float windowPower = 0.0f;
+    for (float w : window)
+    {
+        windowPower += w * w;
+    }
+    overlapGain = windowPower > 0.0f ? float(hopSize) / windowPower : 1.0f;
+
+    fftData.resize(size_t(fftSize * 2));
+
+    for (auto& channel : channels)
+    {
+        channel.inputFifo.assign(size_t(fifoSize), 0.0f);
+        channel.outputAccumulator.assign(size_t(fifoSize), 0.0f);
+        channel.lastPhase.assign(size_t(numBins), 0.0f);
+        channel.synthesisPhase.assign(size_t(numBins), 0.0f);
+    }
+
+    // The ring is only allocated once the engine is used, at the size the
+    // segments need then.
+    maxRingFrames = getRingFrames(maxSegmentLength, hopSize);
+    delete grown.exchange(nullptr);
+    delete retired.exchange(nullptr);
+    requestedFrames.store(0);
+    largestGrown = 0;
+    ring.reset();
+    numFrames = 0;
+
+    reset();
+}
+
+void SpectralReverse::reset() noexcept
+{
+    // Only the short buffers are cleared. The ring of spectra is left alone:
+    // a segment is never longer than framesCaptured, and synthesise reads
+    // nothing outside the segment being played, blur included, so every
+    // frame it reads was captured after the reset.
+    for (auto& channel : channels)
+    {
+        std::fill(channel.inputFifo.begin(), channel.inputFifo.end(), 0.0f);
+        std::fill(channel.outputAccumulator.begin(), channel.outputAccumulator.end(), 0.0f);
+        std::fill(channel.lastPhase.begin(), channel.lastPhase.end(), 0.0f);
+        std::fill(channel.synthesisPhase.begin(), channel.synthesisPhase.end(), 0.0f);
+    }
+
+    fifoPosition = 0;
+    hopCounter = 0;
+    framePosition = 0;
+    nextStage = numStages;
+    writeFrame = 0;
+    framesCaptured = 0;
+    playStart = 0;
+    playLength = 0;
+    playPosition = 0;
+}
+
+int SpectralReverse::getRingFrames(int segmentLength, int hopSize) noexcept
+{
+    // Room for the segment being played and the one being captured. The
+    // blur stays inside the segment being played.
+    return 2 * (std::max(0, segmentLength) / hopSize + 1);
+}
+
+void SpectralReverse::reserve(int numSamples)
+{
+    int frames = std::min(getRingFrames(numSamples, hopSize), maxRingFrames);
+    adoptGrownRing();
+    if (frames > numFrames)
+    {
+        ring = std::make_unique<Ring>(frames, numBins);
+        numFrames = frames;
+        writeFrame = 0;
+        framesCaptured = 0;
+        playStart = 0;
+        playLength = 0;
+        playPosition = 0;
+    }
+}
+
+void SpectralReverse::adoptGrownRing() noexcept
+{
+    auto* next = grown.exchange(nullptr, std::memory_order_acquire);
+    if (next == nullptr)
+    {
+        return;
+    }
+    if (next->numFrames <= numFrames)
+    {
+        // reserve got there first.
+        jassert(retired.load() == nullptr);
+        retired.store(next, std::memory_order_release);
+        return;
+    }
+
+    // The background thread frees the old ring before it grows the next
+    // one, so the slot is always empty here.
+    jassert(retired.load() == nullptr);
+    retired.store(ring.release(), std::memory_order_release);
+    ring.reset(next);
+    numFrames = next->numFrames;
+
+    // The new ring holds nothing yet, so the capture starts over.
+    writeFrame = 0;
+    framesCaptured = 0;
+    playStart = 0;
+    playLength = 0;
+    playPosition = 0;
+}
+
+int SpectralReverse::useTimeSlice()
+{
+    const juce::ScopedLock sl(growLock);
+    delete retired.exchange(nullptr, std::memory_order_acquire);
+
+    int frames = requestedFrames.load();
+    if (frames > largestGrown && grown.load() == nullptr)
+    {
+        grown.store(new Ring(frames, numBins), std::memory_order_release);
+        largestGrown = frames;
+    }
+
+    // Growing is rare, but the first segments wait for it.
+    return 50;
+}
+
+void SpectralReverse::setSegmentLength(int numSamples) noexcept
+{
+    adoptGrownRing();
+
+    int wantedFrames = std::max(1, numSamples / hopSize);
+    int neededRingFrames = std::min(getRingFrames(numSamples, hopSize), maxRingFrames);
+    if (neededRingFrames > numFrames)
+    {
+        // Doubling keeps a sweep of the delay time from restarting the
+        // capture at every block.
+        int frames = std::min(std::max(neededRingFrames, 2 * numFrames), maxRingFrames);
+        if (frames > requestedFrames.load(std::memory_order_relaxed))
+        {
+            requestedFrames.store(frames, std::memory_order_relaxed);
+        }
+    }
+
+    segmentFrames = juce::jlimit(1, std::max(1, numFrames / 2), wantedFrames);
+}
+
+void SpectralReverse::setBlur(float amount) noexcept
+{
+    blurFrames = juce::roundToInt(juce::jlimit(0.0f, 1.0f, amount) * float(maxBlurFrames));
+}
+
+void SpectralReverse::processSample(float inputL, float inputR, float& outputL, float& outputR) noexcept
+{
+    channels[0].inputFifo[size_t(fifoPosition)] = inputL;
+    channels[1].inputFifo[size_t(fifoPosition)] = inputR;
+
+    outputL = channels[0].outputAccumulator[size_t(fifoPosition)];
+    outputR = channels[1].outputAccumulator[size_t(fifoPosition)];
+    channels[0].outputAccumulator[size_t(fifoPosition)] = 0.0f;
+    channels[1].outputAccumulator[size_t(fifoPosition)] = 0.0f;
+
+    if (++fifoPosition == fifoSize)
+    {
+        fifoPosition = 0;
+    }
+
+    if (++hopCounter == hopSize)
+    {
+        // The previous frame has had the whole hop for its stages.
+        jassert(nextStage == numStages);
+        hopCounter = 0;
+        framePosition = fifoPosition;
+        nextStage = 0;
+    }
+
+    while (nextStage < numStages && hopCounter >= nextStage * hopSize / numStages)
+    {
+        processStage(nextStage++);
+    }
+}
+
+void SpectralReverse::processStage(int stage) noexcept
+{
+    if (ring == nullptr)
+    {
+        return;
+    }
+
+    // While frozen, nothing new is captured and the current frame repeats.
+    // Both halves of the capture follow the state at the first one.
+    if (stage == 0)
+    {
+        frameFrozen = freeze;
+    }
+    if (stage < 2)
+    {
+        if (!frameFrozen)
+        {
+            analyse(stage);
+        }
+        if (stage == 0 || frameFrozen)
+        {
+            return;
+        }
+
+        writeFrame = (writeFrame + 1) % numFrames;
+        framesCaptured = std::min(framesCaptured + 1, numFrames);
+
+        if (++playPosition >= playLength)
+        {
+            playLength = std::min(segmentFrames, framesCaptured);
+            playStart = (writeFrame + numFrames - playLength) % numFrames;
+            playPosition = 0;
+        }
+        return;
+    }
+
+    if (playLength == 0)
+    {
+        return;
+    }
+    jassert(playLength <= framesCaptured);
+
+    int frame = (playStart + playLength - 1 - playPosition) % numFrames;
+    synthesise(stage - 2, frame);
+}
+
+void SpectralReverse::analyse(int channelIndex) noexcept
+{
+    auto& channel = channels[size_t(channelIndex)];
+
+    // The frame is the last fftSize samples before framePosition, which
+    // the FIFO keeps for the hop after it.
+    for (int i = 0; i < fftSize; ++i)
+    {
+        int index = (framePosition + hopSize + i) % fifoSize;
+        fftData[size_t(i)] = channel.inputFifo[size_t(index)] * window[size_t(i)];
+    }
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    fft->performRealOnlyForwardTransform(fftData.data(), true);
+
+    float* magnitudes = ring->magnitudes[size_t(channelIndex)].data() + writeFrame * numBins;
+    float* phaseAdvances = ring->phaseAdvances[size_t(channelIndex)].data() + writeFrame * numBins;
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        float re = fftData[size_t(2 * bin)];
+        float im = fftData[size_t(2 * bin + 1)];
+        float phase = std::atan2(im, re);
+
+        magnitudes[bin] = std::sqrt(re * re + im * im);
+        phaseAdvances[bin] = wrapPhase(phase - channel.lastPhase[size_t(bin)]);
+        channel.lastPhase[size_t(bin)] = phase;
+    }
+}
+
+void SpectralReverse::synthesise(int channelIndex, int frame) noexcept
+{
+    auto& channel = channels[size_t(channelIndex)];
+    const float* ringMagnitudes = ring->magnitudes[size_t(channelIndex)].data();
+    const float* magnitudes = ringMagnitudes + frame * numBins;
+    const float* phaseAdvances = ring->phaseAdvances[size_t(channelIndex)].data() + frame * numBins;
+
+    // Blur smears each bin over the neighbouring frames, but only those of
+    // the segment being played. Past its ends the ring holds frames from
+    // long before, or from before a reset.
+    int position = playLength - 1 - playPosition;
+    int firstOffset = -std::min(blurFrames, position);
+    int lastOffset = std::min(blurFrames, playLength - 1 - position);
+    float blurGain = 1.0f / float(lastOffset - firstOffset + 1);
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        float magnitude = magnitudes[bin];
+
+        if (lastOffset > firstOffset)
+        {
+            for (int offset = firstOffset; offset <= lastOffset; ++offset)
+            {
+                if (offset != 0)
+                {
+                    int neighbour = (frame + numFrames + offset) % numFrames;
+                    magnitude += ringMagnitudes[neighbour * numBins + bin];
+                }
+            }
+            magnitude *= blurGain;
+        }
+
+        // Phases keep moving forwards even though the frames are played in
+        // reverse, so every partial stays at its original frequency.
+        float phase = wrapPhase(channel.synthesisPhase[size_t(bin)] + phaseAdvances[bin]);
+        channel.synthesisPhase[size_t(bin)] = phase;
+
+        fftData[size_t(2 * bin)] = magnitude * std::cos(phase);
+        fftData[size_t(2 * bin + 1)] = magnitude * std::sin(phase);
+    }
+
+    std::fill(fftData.begin() + 2 * numBins, fftData.end(), 0.0f);
+    fft->performRealOnlyInverseTransform(fftData.data());
+
+    // Played from a hop after framePosition on, past the part of the
+    // accumulator being read while the stages run.
+    for (int i = 0; i < fftSize; ++i)
+    {
+        int index = (framePosition + hopSize + i) % fifoSize;
+        channel.outputAccumulator[size_t(index)] += fftData[size_t(i)] * window[size_t(i)] * overlapGain;
+    }
+}
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    SpectralReverse.h
+    Created: 19 Oct 2026 1:26:09pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Reverses the delay in the frequency domain. Incoming audio is cut into
+// overlapping STFT frames that are stored as magnitudes and phase advances.
+// Each segment is then resynthesised with its frames in reverse order while
+// the phases keep advancing forwards, like a phase vocoder, which avoids the
+// clicks of the time-domain engine at segment boundaries.
+//
+// The four transforms of a hop are spread over the following hop, one at a
+// time, so a block smaller than the hop never carries all of them. That
+// costs one hop of latency.
+//
+// The ring of spectra is sized to the segment length in use rather than the
+// longest one. A background thread shared by all instances grows it, the
+// audio thread only swaps pointers, and the old ring goes back to that
+// thread to be freed.
+class SpectralReverse : private juce::TimeSliceClient
+{
+public:
+    SpectralReverse();
+    ~SpectralReverse() override;
+
+    struct Options
+    {
+        int fftOrder = 11;
+        int hopSize = 512;
+        juce::dsp::WindowingFunction<float>::WindowingMethod window = juce::dsp::WindowingFunction<float>::hann;
+    };
+
+    // Allocates everything but the ring of spectra, which is dropped.
+    void prepare(int maxSegmentLength, const Options& options);
+    void reset() noexcept;
+
+    // Not for the audio thread. Grows the ring for segments of up to
+    // numSamples right away, for prepareToPlay when the engine is already on
+    // and for offline renders, which must not depend on the timing of the
+    // background thread.
+    void reserve(int numSamples);
+
+    // Audio thread. A segment longer than the ring allows is cut to fit and
+    // the background thread is asked for a larger ring. Once it arrives the
+    // capture starts over in it, as after a reset.
+    void setSegmentLength(int numSamples) noexcept;
+    void setFreeze(bool shouldFreeze) noexcept
+    {
+        freeze = shouldFreeze;
+    }
+    void setBlur(float amount) noexcept;
+
+    void processSample(float inputL, float inputR, float& outputL, float& outputR) noexcept;
+
+    // One FFT length for the frame and one hop for the spread transforms.
+    int getLatency() const noexcept
+    {
+        return fftSize + hopSize;
+    }
+
+private:
+    // Analysis of each channel, then synthesis of each channel.
+    static constexpr int numStages = 4;
+    void processStage(int stage) noexcept;
+    void analyse(int channel) noexcept;
+    void synthesise(int channel, int frame) noexcept;
+
+    static constexpr int maxBlurFrames = 8;
+
+    // numFrames * numBins values per channel each.
+    struct Ring
+    {
+        Ring(int numFrames, int numBins);
+
+        int numFrames = 0;
+        std::array<std::vector<float>, 2> magnitudes;
+        std::array<std::vector<float>, 2> phaseAdvances;
+    };
+
+    static int getRingFrames(int segmentLength, int hopSize) noexcept;
+    void adoptGrownRing() noexcept;
+
+    class GrowThread : public juce::TimeSliceThread
+    {
+    public:
+        GrowThread();
+        ~GrowThread() override;
+    };
+
+    int useTimeSlice() override;
+
+    std::unique_ptr<juce::dsp::FFT> fft;
+    int fftSize = 0;
+    int hopSize = 0;
+    int numBins = 0;
+    int maxRingFrames = 0;
+    float overlapGain = 1.0f;
+
+    // The input FIFO and the output accumulator are a hop longer than the
+    // FFT, so the frame being worked on stays intact while the next hop
+    // arrives.
+    int fifoSize = 0;
+
+    std::vector<float> window;
+    std::vector<float> fftData;
+
+    struct Channel
+    {
+        std::vector<float> inputFifo;
+        std::vector<float> outputAccumulator;
+        std::vector<float> lastPhase;
+        std::vector<float> synthesisPhase;
+    };
+    std::array<Channel, 2> channels;
+
+    int fifoPosition = 0;
+    int hopCounter = 0;
+
+    // Where the FIFO stood when the current frame was complete, and the next
+    // stage of it to run.
+    int framePosition = 0;
+    int nextStage = numStages;
+    bool frameFrozen = false;
+
+    std::unique_ptr<Ring> ring;
+    int numFrames = 0;
+
+    // Rings on their way from and back to the background thread, and the
+    // size it was asked for.
+    juce::CriticalSection growLock;
+    std::atomic<Ring*> grown { nullptr };
+    std::atomic<Ring*> retired { nullptr };
+    std::atomic<int> requestedFrames { 0 };
+    int largestGrown = 0;
+    juce::SharedResourcePointer<GrowThread> growThread;
+
+    int writeFrame = 0;
+    int framesCaptured = 0;
+    int segmentFrames = 1;
+
+    int playStart = 0;
+    int playLength = 0;
+    int playPosition = 0;
+
+    bool freeze = false;
+    int blurFrames = 0;
+};
@@ -9,6 +9,7 @@
 */
 
 #include "Tempo.h"
+#include "Trace.h"
 
 static std::array<double, 16> noteLengthMultipliers =
 {
@@ -35,17 +36,14 @@ void Tempo::reset() noexcept
     bpm = 120.0; 
 }
 
-void Tempo::update(const juce::AudioPlayHead* playhead) noexcept
+void Tempo::update(const juce::Optional<juce::AudioPlayHead::PositionInfo>& position) noexcept
 {
+    DELAY_TRACE_ZONE("Tempo::update");
     reset();
     
-    if (playhead == nullptr) { return; }
+    if (!position.hasValue()) { return; }
     
-    const auto opt = playhead->getPosition();
-    
-    if (!opt.hasValue()) { return; }
-    
-    const auto& pos = *opt;
+    const auto& pos = *position;
     
     if (pos.getBpm().hasValue())
     {
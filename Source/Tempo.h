@@ -14,7 +14,7 @@
 class Tempo {
 public:
     void reset() noexcept;
-    void update(const juce::AudioPlayHead* playhead) noexcept; 
+    void update(const juce::Optional<juce::AudioPlayHead::PositionInfo>& position) noexcept; 
     double getMillisecondsForNoteLength(int index) const noexcept;
     double getTempo() const noexcept 
     {
@@ -0,0 +1,158 @@
+/*
+  ==============================================================================
+
+    Trace.cpp
+    Created: 19 Oct 2026 5:34:51pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "Trace.h"
+
+// Written by its own thread only. The count is published after the event,
+// so every event below the count a reader loads is complete.
+struct Trace::Ring
+{
+    static constexpr int capacity = 1 << 16;
+
+    juce::HeapBlock<Event> events { capacity };
+    std::atomic<juce::uint64> count { 0 };
+    juce::String threadName;
+    int threadIndex = 0;
+};
+
+// Rings live until the process exits, so a thread that ends before the
+// export still shows up in it.
+struct Trace::Registry
+{
+    juce::CriticalSection lock;
+    juce::OwnedArray<Ring> rings;
+    std::atomic<juce::int64> startTicks { 0 };
+};
+
+Trace::Registry& Trace::getRegistry() noexcept
+{
+    static Registry registry;
+    return registry;
+}
+
+void Trace::start() noexcept
+{
+    getRegistry().startTicks.store(juce::Time::getHighResolutionTicks());
+    running.store(true);
+}
+
+void Trace::stop() noexcept
+{
+    running.store(false);
+}
+
+void Trace::counter(const char* name, double value) noexcept
+{
+    if (isRunning())
+    {
+        record(name, juce::Time::getHighResolutionTicks(), -1, value);
+    }
+}
+
+Trace::Ring& Trace::getRing() noexcept
+{
+    thread_local Ring* ring = nullptr;
+    if (ring == nullptr)
+    {
+        auto& registry = getRegistry();
+        const juce::ScopedLock lock(registry.lock);
+
+        auto* newRing = registry.rings.add(new Ring());
+        newRing->threadIndex = registry.rings.size();
+
+        if (auto* thread = juce::Thread::getCurrentThread())
+        {
+            newRing->threadName = thread->getThreadName();
+        }
+        else if (juce::MessageManager::existsAndIsCurrentThread())
+        {
+            newRing->threadName = "Message thread";
+        }
+        else
+        {
+            newRing->threadName = "Thread " + juce::String(newRing->threadIndex);
+        }
+        ring = newRing;
+    }
+    return *ring;
+}
+
+void Trace::record(const char* name, juce::int64 ticks, juce::int64 duration, double value) noexcept
+{
+    auto& ring = getRing();
+    auto count = ring.count.load(std::memory_order_relaxed);
+    ring.events[count & (Ring::capacity - 1)] = { name, ticks, duration, value };
+    ring.count.store(count + 1, std::memory_order_release);
+}
+
+bool Trace::writeJson(const juce::File& file)
+{
+    file.deleteFile();
+    juce::FileOutputStream out(file);
+    if (out.failedToOpen())
+    {
+        return false;
+    }
+
+    auto& registry = getRegistry();
+    auto origin = registry.startTicks.load();
+    double microsecondsPerTick = 1.0e6 / double(juce::Time::getHighResolutionTicksPerSecond());
+    auto toMicroseconds = [=](juce::int64 ticks) { return juce::String(double(ticks) * microsecondsPerTick, 3); };
+
+    out << "{\"traceEvents\":[\n";
+    const char* separator = "";
+
+    const juce::ScopedLock lock(registry.lock);
+    for (auto* ring : registry.rings)
+    {
+        juce::String tid(ring->threadIndex);
+        out << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+            << ",\"args\":{\"name\":\"" << juce::JSON::escapeString(ring->threadName) << "\"}}";
+        separator = ",\n";
+
+        auto end = ring->count.load(std::memory_order_acquire);
+        auto begin = end > juce::uint64(Ring::capacity) ? end - juce::uint64(Ring::capacity) : 0;
+        std::vector<Event> events;
+        events.reserve(size_t(end - begin));
+        for (auto i = begin; i < end; ++i)
+        {
+            events.push_back(ring->events[i & (Ring::capacity - 1)]);
+        }
+
+        // Slots the writer has come round to again while they were copied
+        // hold newer events by now, or half of one.
+        auto endAfterCopy = ring->count.load(std::memory_order_acquire);
+        auto firstValid = endAfterCopy + 1 > juce::uint64(Ring::capacity) ? endAfterCopy + 1 - juce::uint64(Ring::capacity) : 0;
+
+        for (auto i = std::max(begin, firstValid); i < end; ++i)
+        {
+            const auto& event = events[size_t(i - begin)];
+            if (event.ticks < origin)
+            {
+                continue;
+            }
+
+            out << separator << "{\"name\":\"" << event.name << "\",\"pid\":1,\"tid\":" << tid
+                << ",\"ts\":" << toMicroseconds(event.ticks - origin);
+            if (event.duration < 0)
+            {
+                out << ",\"ph\":\"C\",\"args\":{\"value\":" << juce::String(event.value) << "}}";
+            }
+            else
+            {
+                out << ",\"ph\":\"X\",\"dur\":" << toMicroseconds(event.duration) << "}";
+            }
+        }
+    }
+
+    out << "\n]}\n";
+    out.flush();
+    return out.getStatus().wasOk();
+}
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    Trace.h
+    Created: 19 Oct 2026 5:34:51pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Timing zones and counters for finding out where a block spends its time.
+//
+// Everything compiles away unless DELAY_TRACING is defined to 1. With it, a
+// zone costs one relaxed load while no capture is running, and two clock
+// reads plus one write into a ring while one is. Every thread writes into a
+// ring of its own, so recording never takes a lock. Only the first event on
+// a thread does, to register the ring.
+//
+// A ring holds the last 65536 events of its thread, a few seconds of a busy
+// audio thread. Older events are overwritten.
+#ifndef DELAY_TRACING
+ #define DELAY_TRACING 0
+#endif
+
+#if DELAY_TRACING
+ #define DELAY_TRACE_ZONE(name) Trace::Zone JUCE_JOIN_MACRO(traceZone, __LINE__) (name)
+ #define DELAY_TRACE_COUNTER(name, value) Trace::counter(name, double(value))
+#else
+ #define DELAY_TRACE_ZONE(name)
+ #define DELAY_TRACE_COUNTER(name, value)
+#endif
+
+class Trace
+{
+public:
+    // Starts a capture. Events recorded before this are left out of exports.
+    static void start() noexcept;
+    static void stop() noexcept;
+
+    static bool isRunning() noexcept
+    {
+        return running.load(std::memory_order_relaxed);
+    }
+
+    // Writes the captured events as Chrome trace JSON, which chrome://tracing
+    // and ui.perfetto.dev both open. Stop the capture first, otherwise events
+    // that are overwritten while they are copied are dropped.
+    static bool writeJson(const juce::File& file);
+
+    // Names must be string literals, only the pointer is stored.
+    static void counter(const char* name, double value) noexcept;
+
+    class Zone
+    {
+    public:
+        explicit Zone(const char* name_) noexcept
+            : name(name_), startTicks(isRunning() ? juce::Time::getHighResolutionTicks() : 0)
+        {
+        }
+
+        ~Zone()
+        {
+            if (startTicks != 0)
+            {
+                record(name, startTicks, juce::Time::getHighResolutionTicks() - startTicks, 0.0);
+            }
+        }
+
+    private:
+        const char* name;
+        juce::int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE(Zone)
+    };
+
+private:
+    // A duration of -1 marks a counter.
+    struct Event
+    {
+        const char* name;
+        juce::int64 ticks;
+        juce::int64 duration;
+        double value;
+    };
+
+    struct Ring;
+    struct Registry;
+
+    static void record(const char* name, juce::int64 ticks, juce::int64 duration, double value) noexcept;
+    static Ring& getRing() noexcept;
+    static Registry& getRegistry() noexcept;
+
+    static inline std::atomic<bool> running { false };
+};
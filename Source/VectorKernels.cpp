@@ -0,0 +1,1077 @@
+/*
+  ==============================================================================
+
+    VectorKernels.cpp
+    Created: 19 Oct 2026 2:41:53pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "VectorKernels.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+ #if JUCE_MSVC
+  // MSVC allows every intrinsic regardless of the /arch setting.
+  #define DELAY_TARGET(isa)
+ #else
+  #define DELAY_TARGET(isa) __attribute__((target(isa)))
+ #endif
+#endif
+
+//==============================================================================
+namespace scalar
+{
+    static void interpolate(float* dest, const float* newer, const float* older,
+                            float fraction, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] = newer[i] + fraction * (older[i] - newer[i]);
+        }
+    }
+
+    static void interpolateHalf(float* dest, const juce::uint16* newer, const juce::uint16* older,
+                                float fraction, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float n = HalfFloat::toFloat(newer[i]);
+            float o = HalfFloat::toFloat(older[i]);
+            dest[i] = n + fraction * (o - n);
+        }
+    }
+
+    static void encodeHalf(juce::uint16* dest, const float* source, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            dest[i] = HalfFloat::fromFloat(source[i]);
+        }
+    }
+
+    static void scale(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                      float gain, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            destL[i] = sourceL[i] * gain;
+            destR[i] = sourceR[i] * gain;
+        }
+    }
+
+    static void panInput(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                         const float* feedbackL, const float* feedbackR,
+                         float panL, float panR, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float mono = (sourceL[i] + sourceR[i]) * 0.5f;
+            destL[i] = mono * panL + feedbackR[i];
+            destR[i] = mono * panR + feedbackL[i];
+        }
+    }
+
+    static void mix(float* destL, float* destR, const float* dryL, const float* dryR,
+                    const float* wetL, const float* wetR, float dryGain, float wetGain,
+                    int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            destL[i] = dryL[i] * dryGain + wetL[i] * wetGain;
+            destR[i] = dryR[i] * dryGain + wetR[i] * wetGain;
+        }
+    }
+
+    static void mixRamped(float* destL, float* destR, const float* dryL, const float* dryR,
+                          const float* wetL, const float* wetR, const float* gains, const float* mixes,
+                          int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            destL[i] = (dryL[i] + (wetL[i] - dryL[i]) * mixes[i]) * gains[i];
+            destR[i] = (dryR[i] + (wetR[i] - dryR[i]) * mixes[i]) * gains[i];
+        }
+    }
+
+    // Bits without the sign compare like the magnitudes, and infinity and
+    // NaN compare larger than any finite value.
+    static juce::uint32 peakBits(const float* left, const float* right, int numSamples) noexcept
+    {
+        juce::uint32 largest = 0;
+        for (int i = 0; i < numSamples; ++i)
+        {
+            largest = std::max(largest, std::bit_cast<juce::uint32>(left[i]) & 0x7fffffffu);
+            largest = std::max(largest, std::bit_cast<juce::uint32>(right[i]) & 0x7fffffffu);
+        }
+        return largest;
+    }
+
+    static float peak(const float* left, const float* right, int numSamples) noexcept
+    {
+        return std::bit_cast<float>(peakBits(left, right, numSamples));
+    }
+
+    // One sample through every lane. The lanes are processed from the top,
+    // so each one reads its input before the lane below overwrites it. A
+    // lane whose mask is zero computes but keeps its state.
+    static void filterStep(VectorKernels::FilterLanes& lanes, const juce::uint32* mask) noexcept
+    {
+        for (int i = lanes.numLanes - 1; i >= 0; --i)
+        {
+            float x = lanes.pipe[i];
+            float hp = lanes.h[i] * (x - lanes.s1[i] * lanes.gR[i] - lanes.s2[i]);
+            float bp = hp * lanes.g[i] + lanes.s1[i];
+            float lp = bp * lanes.g[i] + lanes.s2[i];
+
+            if (mask == nullptr || mask[i] != 0)
+            {
+                lanes.s1[i] = hp * lanes.g[i] + bp;
+                lanes.s2[i] = bp * lanes.g[i] + lp;
+            }
+            lanes.pipe[i + 2] = hp * lanes.highpassGain[i] + lp * lanes.lowpassGain[i];
+        }
+    }
+
+    static float readVoice(const VectorKernels::DelayLanes& lanes, int voice, float delay) noexcept
+    {
+        int delayInt = int(delay);
+        if (delayInt > lanes.numValid)
+        {
+            return 0.0f;
+        }
+
+        int newer = lanes.writeIndex - delayInt;
+        newer += newer < 0 ? lanes.size : 0;
+        int older = newer - 1;
+        older += older < 0 ? lanes.size : 0;
+
+        float fraction = delay - float(delayInt);
+        float n = lanes.history[newer * lanes.stride + voice];
+        float o = lanes.history[older * lanes.stride + voice];
+        return n + fraction * (o - n);
+    }
+
+    static void advanceLanes(VectorKernels::DelayLanes& lanes) noexcept
+    {
+        lanes.writeIndex = lanes.writeIndex + 1 == lanes.size ? 0 : lanes.writeIndex + 1;
+        lanes.numValid = std::min(lanes.numValid + 1, lanes.size);
+    }
+
+    static void delayLanes(VectorKernels::DelayLanes& lanes, float* frames, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = frames + i * lanes.stride;
+            float* row = lanes.history + lanes.writeIndex * lanes.stride;
+
+            for (int voice = 0; voice < lanes.stride; voice += 2)
+            {
+                float wet[2];
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    int v = voice + channel;
+                    lanes.delay[v] += lanes.delayStep[v];
+                    wet[channel] = readVoice(lanes, v, lanes.delay[v]);
+                }
+
+                float mono = (frame[voice] + frame[voice + 1]) * 0.5f;
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    int v = voice + channel;
+                    lanes.feedback[v] += lanes.feedbackStep[v];
+                    lanes.pan[v] += lanes.panStep[v];
+                    lanes.dryGain[v] += lanes.dryGainStep[v];
+                    lanes.wetGain[v] += lanes.wetGainStep[v];
+
+                    float x = frame[v];
+                    row[v] = mono * lanes.pan[v] + wet[1 - channel] * lanes.feedback[v];
+                    frame[v] = x * lanes.dryGain[v] + wet[channel] * lanes.wetGain[v];
+                }
+            }
+            advanceLanes(lanes);
+        }
+    }
+}
+
+// Feeds a block into the pipelined filter lanes. Each section lags one
+// sample behind the one before it, so the first and last few steps of a
+// block run with the sections outside the block masked off. That drains
+// the pipeline, and the next block starts from a clean state.
+template<void (*Step)(VectorKernels::FilterLanes&, const juce::uint32*) noexcept>
+static void runFilter(VectorKernels::FilterLanes& lanes, float* left, float* right, int numSamples) noexcept
+{
+    int numSections = lanes.numLanes / 2;
+    int numSteps = numSamples + numSections - 1;
+
+    for (int step = 0; step < numSteps; ++step)
+    {
+        if (step < numSamples)
+        {
+            lanes.pipe[0] = left[step];
+            lanes.pipe[1] = right[step];
+        }
+
+        if (step >= numSections - 1 && step < numSamples)
+        {
+            Step(lanes, nullptr);
+        }
+        else
+        {
+            int first = std::max(0, step - numSamples + 1);
+            int last = std::min(step, numSections - 1);
+            for (int section = 0; section < numSections; ++section)
+            {
+                juce::uint32 valid = section >= first && section <= last ? 0xffffffffu : 0u;
+                lanes.mask[2 * section] = valid;
+                lanes.mask[2 * section + 1] = valid;
+            }
+            Step(lanes, lanes.mask);
+        }
+
+        int output = step - numSections + 1;
+        if (output >= 0)
+        {
+            left[output] = lanes.pipe[lanes.numLanes];
+            right[output] = lanes.pipe[lanes.numLanes + 1];
+        }
+    }
+}
+
+#if JUCE_INTEL
+
+//==============================================================================
+// Every vector loop hands its remainder to the scalar version.
+namespace sse2
+{
+    DELAY_TARGET("sse2")
+    static void interpolate(float* dest, const float* newer, const float* older,
+                            float fraction, int numSamples) noexcept
+    {
+        __m128 f = _mm_set1_ps(fraction);
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            __m128 n = _mm_loadu_ps(newer + i);
+            __m128 o = _mm_loadu_ps(older + i);
+            _mm_storeu_ps(dest + i, _mm_add_ps(n, _mm_mul_ps(f, _mm_sub_ps(o, n))));
+        }
+        scalar::interpolate(dest + i, newer + i, older + i, fraction, numSamples - i);
+    }
+
+    // HalfFloat::toFloat on four halves held in the low bits of each lane.
+    DELAY_TARGET("sse2")
+    static __m128 halfToFloat(__m128i halves) noexcept
+    {
+        const __m128i shiftedExponent = _mm_set1_epi32(0x7c00 << 13);
+        __m128i bits = _mm_slli_epi32(_mm_and_si128(halves, _mm_set1_epi32(0x7fff)), 13);
+        __m128i exponent = _mm_and_si128(bits, shiftedExponent);
+        bits = _mm_add_epi32(bits, _mm_set1_epi32((127 - 15) << 23));
+
+        __m128i special = _mm_cmpeq_epi32(exponent, shiftedExponent);
+        bits = _mm_add_epi32(bits, _mm_and_si128(special, _mm_set1_epi32((128 - 16) << 23)));
+
+        __m128 subnormal = _mm_castsi128_ps(_mm_cmpeq_epi32(exponent, _mm_setzero_si128()));
+        __m128 renormalised = _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, _mm_set1_epi32(1 << 23))),
+                                         _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+        __m128 value = _mm_or_ps(_mm_and_ps(subnormal, renormalised), _mm_andnot_ps(subnormal, _mm_castsi128_ps(bits)));
+
+        __m128i sign = _mm_slli_epi32(_mm_and_si128(halves, _mm_set1_epi32(0x8000)), 16);
+        return _mm_or_ps(value, _mm_castsi128_ps(sign));
+    }
+
+    // HalfFloat::fromFloat on four floats. The sign is shifted in with an
+    // arithmetic shift, so the results stay sign-extended for the pack.
+    DELAY_TARGET("sse2")
+    static __m128i floatToHalf(__m128 value) noexcept
+    {
+        __m128 sign = _mm_and_ps(value, _mm_castsi128_ps(_mm_set1_epi32(int(0x80000000u))));
+        __m128 magnitude = _mm_xor_ps(value, sign);
+        __m128i bits = _mm_castps_si128(magnitude);
+
+        __m128 isNaN = _mm_cmpunord_ps(magnitude, magnitude);
+        __m128i regular = _mm_cmpgt_epi32(_mm_set1_epi32(0x47800000), bits);
+        __m128i special = _mm_or_si128(_mm_and_si128(_mm_castps_si128(isNaN), _mm_set1_epi32(0x200)), _mm_set1_epi32(0x7c00));
+
+        __m128i subnormal = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), bits);
+        __m128i subnormalBits = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(magnitude, _mm_set1_ps(0.5f))),
+                                              _mm_set1_epi32(0x3f000000));
+
+        __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+        __m128i normalBits = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, _mm_set1_epi32(int(0xc8000fffu))), mantissaOdd), 13);
+
+        __m128i finite = _mm_or_si128(_mm_and_si128(subnormal, subnormalBits), _mm_andnot_si128(subnormal, normalBits));
+        __m128i result = _mm_or_si128(_mm_and_si128(regular, finite), _mm_andnot_si128(regular, special));
+        return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+    }
+
+    DELAY_TARGET("sse2")
+    static void interpolateHalf(float* dest, const juce::uint16* newer, const juce::uint16* older,
+                                float fraction, int numSamples) noexcept
+    {
+        __m128 f = _mm_set1_ps(fraction);
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            __m128i zero = _mm_setzero_si128();
+            __m128 n = halfToFloat(_mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(newer + i)), zero));
+            __m128 o = halfToFloat(_mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(older + i)), zero));
+            _mm_storeu_ps(dest + i, _mm_add_ps(n, _mm_mul_ps(f, _mm_sub_ps(o, n))));
+        }
+        scalar::interpolateHalf(dest + i, newer + i, older + i, fraction, numSamples - i);
+    }
+
+    DELAY_TARGET("sse2")
+    static void encodeHalf(juce::uint16* dest, const float* source, int numSamples) noexcept
+    {
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            __m128i low = floatToHalf(_mm_loadu_ps(source + i));
+            __m128i high = floatToHalf(_mm_loadu_ps(source + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packs_epi32(low, high));
+        }
+        scalar::encodeHalf(dest + i, source + i, numSamples - i);
+    }
+
+    DELAY_TARGET("sse2")
+    static void scale(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                      float gain, int numSamples) noexcept
+    {
+        __m128 g = _mm_set1_ps(gain);
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            _mm_storeu_ps(destL + i, _mm_mul_ps(_mm_loadu_ps(sourceL + i), g));
+            _mm_storeu_ps(destR + i, _mm_mul_ps(_mm_loadu_ps(sourceR + i), g));
+        }
+        scalar::scale(destL + i, destR + i, sourceL + i, sourceR + i, gain, numSamples - i);
+    }
+
+    DELAY_TARGET("sse2")
+    static void panInput(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                         const float* feedbackL, const float* feedbackR,
+                         float panL, float panR, int numSamples) noexcept
+    {
+        __m128 half = _mm_set1_ps(0.5f);
+        __m128 pl = _mm_set1_ps(panL);
+        __m128 pr = _mm_set1_ps(panR);
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            __m128 mono = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(sourceL + i), _mm_loadu_ps(sourceR + i)), half);
+            _mm_storeu_ps(destL + i, _mm_add_ps(_mm_mul_ps(mono, pl), _mm_loadu_ps(feedbackR + i)));
+            _mm_storeu_ps(destR + i, _mm_add_ps(_mm_mul_ps(mono, pr), _mm_loadu_ps(feedbackL + i)));
+        }
+        scalar::panInput(destL + i, destR + i, sourceL + i, sourceR + i,
+                         feedbackL + i, feedbackR + i, panL, panR, numSamples - i);
+    }
+
+    DELAY_TARGET("sse2")
+    static void mix(float* destL, float* destR, const float* dryL, const float* dryR,
+                    const float* wetL, const float* wetR, float dryGain, float wetGain,
+                    int numSamples) noexcept
+    {
+        __m128 dg = _mm_set1_ps(dryGain);
+        __m128 wg = _mm_set1_ps(wetGain);
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            __m128 l = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(dryL + i), dg), _mm_mul_ps(_mm_loadu_ps(wetL + i), wg));
+            __m128 r = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(dryR + i), dg), _mm_mul_ps(_mm_loadu_ps(wetR + i), wg));
+            _mm_storeu_ps(destL + i, l);
+            _mm_storeu_ps(destR + i, r);
+        }
+        scalar::mix(destL + i, destR + i, dryL + i, dryR + i, wetL + i, wetR + i,
+                    dryGain, wetGain, numSamples - i);
+    }
+
+    DELAY_TARGET("sse2")
+    static void mixRamped(float* destL, float* destR, const float* dryL, const float* dryR,
+                          const float* wetL, const float* wetR, const float* gains, const float* mixes,
+                          int numSamples) noexcept
+    {
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            __m128 g = _mm_loadu_ps(gains + i);
+            __m128 m = _mm_loadu_ps(mixes + i);
+            __m128 dl = _mm_loadu_ps(dryL + i);
+            __m128 dr = _mm_loadu_ps(dryR + i);
+            __m128 l = _mm_mul_ps(_mm_add_ps(dl, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(wetL + i), dl), m)), g);
+            __m128 r = _mm_mul_ps(_mm_add_ps(dr, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(wetR + i), dr), m)), g);
+            _mm_storeu_ps(destL + i, l);
+            _mm_storeu_ps(destR + i, r);
+        }
+        scalar::mixRamped(destL + i, destR + i, dryL + i, dryR + i, wetL + i, wetR + i,
+                          gains + i, mixes + i, numSamples - i);
+    }
+
+    // SSE2 has no signed integer maximum, so it compares and selects.
+    DELAY_TARGET("sse2")
+    static __m128i maximum(__m128i a, __m128i b) noexcept
+    {
+        __m128i greater = _mm_cmpgt_epi32(a, b);
+        return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+    }
+
+    DELAY_TARGET("sse2")
+    static float peak(const float* left, const float* right, int numSamples) noexcept
+    {
+        __m128i mask = _mm_set1_epi32(0x7fffffff);
+        __m128i largest = _mm_setzero_si128();
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+        {
+            largest = maximum(largest, _mm_and_si128(_mm_castps_si128(_mm_loadu_ps(left + i)), mask));
+            largest = maximum(largest, _mm_and_si128(_mm_castps_si128(_mm_loadu_ps(right + i)), mask));
+        }
+        alignas(16) juce::uint32 lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), largest);
+        juce::uint32 result = scalar::peakBits(left + i, right + i, numSamples - i);
+        for (auto lane : lanes)
+        {
+            result = std::max(result, lane);
+        }
+        return std::bit_cast<float>(result);
+    }
+
+    DELAY_TARGET("sse2")
+    static void filterStep(VectorKernels::FilterLanes& lanes, const juce::uint32* mask) noexcept
+    {
+        for (int i = lanes.numLanes - 4; i >= 0; i -= 4)
+        {
+            __m128 g = _mm_load_ps(lanes.g + i);
+            __m128 s1 = _mm_load_ps(lanes.s1 + i);
+            __m128 s2 = _mm_load_ps(lanes.s2 + i);
+            __m128 x = _mm_loadu_ps(lanes.pipe + i);
+
+            __m128 hp = _mm_mul_ps(_mm_load_ps(lanes.h + i),
+                                   _mm_sub_ps(_mm_sub_ps(x, _mm_mul_ps(s1, _mm_load_ps(lanes.gR + i))), s2));
+            __m128 bp = _mm_add_ps(_mm_mul_ps(hp, g), s1);
+            __m128 lp = _mm_add_ps(_mm_mul_ps(bp, g), s2);
+            __m128 newS1 = _mm_add_ps(_mm_mul_ps(hp, g), bp);
+            __m128 newS2 = _mm_add_ps(_mm_mul_ps(bp, g), lp);
+
+            if (mask != nullptr)
+            {
+                __m128 m = _mm_castsi128_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(mask + i)));
+                newS1 = _mm_or_ps(_mm_and_ps(m, newS1), _mm_andnot_ps(m, s1));
+                newS2 = _mm_or_ps(_mm_and_ps(m, newS2), _mm_andnot_ps(m, s2));
+            }
+
+            _mm_store_ps(lanes.s1 + i, newS1);
+            _mm_store_ps(lanes.s2 + i, newS2);
+            _mm_storeu_ps(lanes.pipe + i + 2, _mm_add_ps(_mm_mul_ps(hp, _mm_load_ps(lanes.highpassGain + i)),
+                                                         _mm_mul_ps(lp, _mm_load_ps(lanes.lowpassGain + i))));
+        }
+    }
+
+    // Without a gather, the row indices go through memory and the samples
+    // are picked up one by one. The arithmetic around them is still vector.
+    DELAY_TARGET("sse2")
+    static void delayLanes(VectorKernels::DelayLanes& lanes, float* frames, int numSamples) noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi32(1);
+        const __m128i size = _mm_set1_epi32(lanes.size);
+        const __m128 half = _mm_set1_ps(0.5f);
+        int stride = lanes.stride;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = frames + i * stride;
+            float* row = lanes.history + lanes.writeIndex * stride;
+            __m128i writeIndex = _mm_set1_epi32(lanes.writeIndex);
+            __m128i validLimit = _mm_set1_epi32(lanes.numValid + 1);
+
+            for (int v = 0; v < stride; v += 4)
+            {
+                __m128 delay = _mm_add_ps(_mm_load_ps(lanes.delay + v), _mm_load_ps(lanes.delayStep + v));
+                _mm_store_ps(lanes.delay + v, delay);
+                __m128i delayInt = _mm_cvttps_epi32(delay);
+                __m128 fraction = _mm_sub_ps(delay, _mm_cvtepi32_ps(delayInt));
+
+                __m128i newer = _mm_sub_epi32(writeIndex, delayInt);
+                newer = _mm_add_epi32(newer, _mm_and_si128(_mm_cmplt_epi32(newer, zero), size));
+                __m128i older = _mm_sub_epi32(newer, one);
+                older = _mm_add_epi32(older, _mm_and_si128(_mm_cmplt_epi32(older, zero), size));
+
+                alignas(16) int newerRows[4];
+                alignas(16) int olderRows[4];
+                _mm_store_si128(reinterpret_cast<__m128i*>(newerRows), newer);
+                _mm_store_si128(reinterpret_cast<__m128i*>(olderRows), older);
+                const float* column = lanes.history + v;
+                __m128 n = _mm_setr_ps(column[newerRows[0] * stride], column[newerRows[1] * stride + 1],
+                                       column[newerRows[2] * stride + 2], column[newerRows[3] * stride + 3]);
+                __m128 o = _mm_setr_ps(column[olderRows[0] * stride], column[olderRows[1] * stride + 1],
+                                       column[olderRows[2] * stride + 2], column[olderRows[3] * stride + 3]);
+
+                __m128 valid = _mm_castsi128_ps(_mm_cmpgt_epi32(validLimit, delayInt));
+                __m128 wet = _mm_and_ps(valid, _mm_add_ps(n, _mm_mul_ps(fraction, _mm_sub_ps(o, n))));
+                __m128 crossed = _mm_shuffle_ps(wet, wet, _MM_SHUFFLE(2, 3, 0, 1));
+
+                __m128 feedback = _mm_add_ps(_mm_load_ps(lanes.feedback + v), _mm_load_ps(lanes.feedbackStep + v));
+                __m128 dryGain = _mm_add_ps(_mm_load_ps(lanes.dryGain + v), _mm_load_ps(lanes.dryGainStep + v));
+                __m128 wetGain = _mm_add_ps(_mm_load_ps(lanes.wetGain + v), _mm_load_ps(lanes.wetGainStep + v));
+                __m128 pan = _mm_add_ps(_mm_load_ps(lanes.pan + v), _mm_load_ps(lanes.panStep + v));
+                _mm_store_ps(lanes.feedback + v, feedback);
+                _mm_store_ps(lanes.dryGain + v, dryGain);
+                _mm_store_ps(lanes.wetGain + v, wetGain);
+                _mm_store_ps(lanes.pan + v, pan);
+
+                __m128 x = _mm_load_ps(frame + v);
+                __m128 mono = _mm_mul_ps(_mm_add_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1))), half);
+                _mm_store_ps(row + v, _mm_add_ps(_mm_mul_ps(mono, pan),
+                                                 _mm_mul_ps(crossed, feedback)));
+                _mm_store_ps(frame + v, _mm_add_ps(_mm_mul_ps(x, dryGain), _mm_mul_ps(wet, wetGain)));
+            }
+            scalar::advanceLanes(lanes);
+        }
+    }
+}
+
+//==============================================================================
+namespace avx2
+{
+    DELAY_TARGET("avx2,fma")
+    static void interpolate(float* dest, const float* newer, const float* older,
+                            float fraction, int numSamples) noexcept
+    {
+        __m256 f = _mm256_set1_ps(fraction);
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            __m256 n = _mm256_loadu_ps(newer + i);
+            __m256 o = _mm256_loadu_ps(older + i);
+            _mm256_storeu_ps(dest + i, _mm256_fmadd_ps(f, _mm256_sub_ps(o, n), n));
+        }
+        scalar::interpolate(dest + i, newer + i, older + i, fraction, numSamples - i);
+    }
+
+    // Every CPU with AVX2 also has F16C, so it is not checked separately.
+    DELAY_TARGET("avx2,fma,f16c")
+    static void interpolateHalf(float* dest, const juce::uint16* newer, const juce::uint16* older,
+                                float fraction, int numSamples) noexcept
+    {
+        __m256 f = _mm256_set1_ps(fraction);
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            __m256 n = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(newer + i)));
+            __m256 o = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(older + i)));
+            _mm256_storeu_ps(dest + i, _mm256_fmadd_ps(f, _mm256_sub_ps(o, n), n));
+        }
+        scalar::interpolateHalf(dest + i, newer + i, older + i, fraction, numSamples - i);
+    }
+
+    DELAY_TARGET("avx2,fma,f16c")
+    static void encodeHalf(juce::uint16* dest, const float* source, int numSamples) noexcept
+    {
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            __m128i halves = _mm256_cvtps_ph(_mm256_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), halves);
+        }
+        scalar::encodeHalf(dest + i, source + i, numSamples - i);
+    }
+
+    DELAY_TARGET("avx2,fma")
+    static void scale(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                      float gain, int numSamples) noexcept
+    {
+        __m256 g = _mm256_set1_ps(gain);
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            _mm256_storeu_ps(destL + i, _mm256_mul_ps(_mm256_loadu_ps(sourceL + i), g));
+            _mm256_storeu_ps(destR + i, _mm256_mul_ps(_mm256_loadu_ps(sourceR + i), g));
+        }
+        scalar::scale(destL + i, destR + i, sourceL + i, sourceR + i, gain, numSamples - i);
+    }
+
+    DELAY_TARGET("avx2,fma")
+    static void panInput(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                         const float* feedbackL, const float* feedbackR,
+                         float panL, float panR, int numSamples) noexcept
+    {
+        __m256 half = _mm256_set1_ps(0.5f);
+        __m256 pl = _mm256_set1_ps(panL);
+        __m256 pr = _mm256_set1_ps(panR);
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            __m256 mono = _mm256_mul_ps(_mm256_add_ps(_mm256_loadu_ps(sourceL + i), _mm256_loadu_ps(sourceR + i)), half);
+            _mm256_storeu_ps(destL + i, _mm256_fmadd_ps(mono, pl, _mm256_loadu_ps(feedbackR + i)));
+            _mm256_storeu_ps(destR + i, _mm256_fmadd_ps(mono, pr, _mm256_loadu_ps(feedbackL + i)));
+        }
+        scalar::panInput(destL + i, destR + i, sourceL + i, sourceR + i,
+                         feedbackL + i, feedbackR + i, panL, panR, numSamples - i);
+    }
+
+    DELAY_TARGET("avx2,fma")
+    static void mix(float* destL, float* destR, const float* dryL, const float* dryR,
+                    const float* wetL, const float* wetR, float dryGain, float wetGain,
+                    int numSamples) noexcept
+    {
+        __m256 dg = _mm256_set1_ps(dryGain);
+        __m256 wg = _mm256_set1_ps(wetGain);
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            __m256 l = _mm256_fmadd_ps(_mm256_loadu_ps(wetL + i), wg, _mm256_mul_ps(_mm256_loadu_ps(dryL + i), dg));
+            __m256 r = _mm256_fmadd_ps(_mm256_loadu_ps(wetR + i), wg, _mm256_mul_ps(_mm256_loadu_ps(dryR + i), dg));
+            _mm256_storeu_ps(destL + i, l);
+            _mm256_storeu_ps(destR + i, r);
+        }
+        scalar::mix(destL + i, destR + i, dryL + i, dryR + i, wetL + i, wetR + i,
+                    dryGain, wetGain, numSamples - i);
+    }
+
+    DELAY_TARGET("avx2,fma")
+    static void mixRamped(float* destL, float* destR, const float* dryL, const float* dryR,
+                          const float* wetL, const float* wetR, const float* gains, const float* mixes,
+                          int numSamples) noexcept
+    {
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            __m256 g = _mm256_loadu_ps(gains + i);
+            __m256 m = _mm256_loadu_ps(mixes + i);
+            __m256 dl = _mm256_loadu_ps(dryL + i);
+            __m256 dr = _mm256_loadu_ps(dryR + i);
+            __m256 l = _mm256_mul_ps(_mm256_fmadd_ps(_mm256_sub_ps(_mm256_loadu_ps(wetL + i), dl), m, dl), g);
+            __m256 r = _mm256_mul_ps(_mm256_fmadd_ps(_mm256_sub_ps(_mm256_loadu_ps(wetR + i), dr), m, dr), g);
+            _mm256_storeu_ps(destL + i, l);
+            _mm256_storeu_ps(destR + i, r);
+        }
+        scalar::mixRamped(destL + i, destR + i, dryL + i, dryR + i, wetL + i, wetR + i,
+                          gains + i, mixes + i, numSamples - i);
+    }
+
+    DELAY_TARGET("avx2,fma")
+    static float peak(const float* left, const float* right, int numSamples) noexcept
+    {
+        __m256i mask = _mm256_set1_epi32(0x7fffffff);
+        __m256i largest = _mm256_setzero_si256();
+        int i = 0;
+        for (; i + 8 <= numSamples; i += 8)
+        {
+            largest = _mm256_max_epi32(largest, _mm256_and_si256(_mm256_castps_si256(_mm256_loadu_ps(left + i)), mask));
+            largest = _mm256_max_epi32(largest, _mm256_and_si256(_mm256_castps_si256(_mm256_loadu_ps(right + i)), mask));
+        }
+        alignas(32) juce::uint32 lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), largest);
+        juce::uint32 result = scalar::peakBits(left + i, right + i, numSamples - i);
+        for (auto lane : lanes)
+        {
+            result = std::max(result, lane);
+        }
+        return std::bit_cast<float>(result);
+    }
+
+    DELAY_TARGET("avx2,fma")
+    static void filterStep(VectorKernels::FilterLanes& lanes, const juce::uint32* mask) noexcept
+    {
+        for (int i = lanes.numLanes - 8; i >= 0; i -= 8)
+        {
+            __m256 g = _mm256_load_ps(lanes.g + i);
+            __m256 s1 = _mm256_load_ps(lanes.s1 + i);
+            __m256 s2 = _mm256_load_ps(lanes.s2 + i);
+            __m256 x = _mm256_loadu_ps(lanes.pipe + i);
+
+            __m256 hp = _mm256_mul_ps(_mm256_load_ps(lanes.h + i),
+                                      _mm256_sub_ps(_mm256_fnmadd_ps(s1, _mm256_load_ps(lanes.gR + i), x), s2));
+            __m256 bp = _mm256_fmadd_ps(hp, g, s1);
+            __m256 lp = _mm256_fmadd_ps(bp, g, s2);
+            __m256 newS1 = _mm256_fmadd_ps(hp, g, bp);
+            __m256 newS2 = _mm256_fmadd_ps(bp, g, lp);
+
+            if (mask != nullptr)
+            {
+                __m256 m = _mm256_castsi256_ps(_mm256_load_si256(reinterpret_cast<const __m256i*>(mask + i)));
+                newS1 = _mm256_blendv_ps(s1, newS1, m);
+                newS2 = _mm256_blendv_ps(s2, newS2, m);
+            }
+
+            _mm256_store_ps(lanes.s1 + i, newS1);
+            _mm256_store_ps(lanes.s2 + i, newS2);
+            _mm256_storeu_ps(lanes.pipe + i + 2, _mm256_fmadd_ps(hp, _mm256_load_ps(lanes.highpassGain + i),
+                                                                 _mm256_mul_ps(lp, _mm256_load_ps(lanes.lowpassGain + i))));
+        }
+    }
+
+    DELAY_TARGET("avx2,fma")
+    static void delayLanes(VectorKernels::DelayLanes& lanes, float* frames, int numSamples) noexcept
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i size = _mm256_set1_epi32(lanes.size);
+        const __m256i stride = _mm256_set1_epi32(lanes.stride);
+        const __m256i columns = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256 half = _mm256_set1_ps(0.5f);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = frames + i * lanes.stride;
+            float* row = lanes.history + lanes.writeIndex * lanes.stride;
+            __m256i writeIndex = _mm256_set1_epi32(lanes.writeIndex);
+            __m256i validLimit = _mm256_set1_epi32(lanes.numValid + 1);
+
+            for (int v = 0; v < lanes.stride; v += 8)
+            {
+                __m256 delay = _mm256_add_ps(_mm256_load_ps(lanes.delay + v), _mm256_load_ps(lanes.delayStep + v));
+                _mm256_store_ps(lanes.delay + v, delay);
+                __m256i delayInt = _mm256_cvttps_epi32(delay);
+                __m256 fraction = _mm256_sub_ps(delay, _mm256_cvtepi32_ps(delayInt));
+
+                __m256i newer = _mm256_sub_epi32(writeIndex, delayInt);
+                newer = _mm256_add_epi32(newer, _mm256_and_si256(_mm256_cmpgt_epi32(zero, newer), size));
+                __m256i older = _mm256_sub_epi32(newer, one);
+                older = _mm256_add_epi32(older, _mm256_and_si256(_mm256_cmpgt_epi32(zero, older), size));
+
+                const float* column = lanes.history + v;
+                __m256 n = _mm256_i32gather_ps(column, _mm256_add_epi32(_mm256_mullo_epi32(newer, stride), columns), 4);
+                __m256 o = _mm256_i32gather_ps(column, _mm256_add_epi32(_mm256_mullo_epi32(older, stride), columns), 4);
+
+                __m256 valid = _mm256_castsi256_ps(_mm256_cmpgt_epi32(validLimit, delayInt));
+                __m256 wet = _mm256_and_ps(valid, _mm256_fmadd_ps(fraction, _mm256_sub_ps(o, n), n));
+                __m256 crossed = _mm256_permute_ps(wet, _MM_SHUFFLE(2, 3, 0, 1));
+
+                __m256 feedback = _mm256_add_ps(_mm256_load_ps(lanes.feedback + v), _mm256_load_ps(lanes.feedbackStep + v));
+                __m256 dryGain = _mm256_add_ps(_mm256_load_ps(lanes.dryGain + v), _mm256_load_ps(lanes.dryGainStep + v));
+                __m256 wetGain = _mm256_add_ps(_mm256_load_ps(lanes.wetGain + v), _mm256_load_ps(lanes.wetGainStep + v));
+                __m256 pan = _mm256_add_ps(_mm256_load_ps(lanes.pan + v), _mm256_load_ps(lanes.panStep + v));
+                _mm256_store_ps(lanes.feedback + v, feedback);
+                _mm256_store_ps(lanes.dryGain + v, dryGain);
+                _mm256_store_ps(lanes.wetGain + v, wetGain);
+                _mm256_store_ps(lanes.pan + v, pan);
+
+                __m256 x = _mm256_load_ps(frame + v);
+                __m256 mono = _mm256_mul_ps(_mm256_add_ps(x, _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1))), half);
+                _mm256_store_ps(row + v, _mm256_fmadd_ps(mono, pan,
+                                                         _mm256_mul_ps(crossed, feedback)));
+                _mm256_store_ps(frame + v, _mm256_fmadd_ps(x, dryGain, _mm256_mul_ps(wet, wetGain)));
+            }
+            scalar::advanceLanes(lanes);
+        }
+    }
+}
+
+//==============================================================================
+namespace avx512
+{
+    DELAY_TARGET("avx512f")
+    static void interpolate(float* dest, const float* newer, const float* older,
+                            float fraction, int numSamples) noexcept
+    {
+        __m512 f = _mm512_set1_ps(fraction);
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            __m512 n = _mm512_loadu_ps(newer + i);
+            __m512 o = _mm512_loadu_ps(older + i);
+            _mm512_storeu_ps(dest + i, _mm512_fmadd_ps(f, _mm512_sub_ps(o, n), n));
+        }
+        scalar::interpolate(dest + i, newer + i, older + i, fraction, numSamples - i);
+    }
+
+    DELAY_TARGET("avx512f")
+    static void interpolateHalf(float* dest, const juce::uint16* newer, const juce::uint16* older,
+                                float fraction, int numSamples) noexcept
+    {
+        __m512 f = _mm512_set1_ps(fraction);
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            __m512 n = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(newer + i)));
+            __m512 o = _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(older + i)));
+            _mm512_storeu_ps(dest + i, _mm512_fmadd_ps(f, _mm512_sub_ps(o, n), n));
+        }
+        scalar::interpolateHalf(dest + i, newer + i, older + i, fraction, numSamples - i);
+    }
+
+    DELAY_TARGET("avx512f")
+    static void encodeHalf(juce::uint16* dest, const float* source, int numSamples) noexcept
+    {
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            __m256i halves = _mm512_cvtps_ph(_mm512_loadu_ps(source + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), halves);
+        }
+        scalar::encodeHalf(dest + i, source + i, numSamples - i);
+    }
+
+    DELAY_TARGET("avx512f")
+    static void scale(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                      float gain, int numSamples) noexcept
+    {
+        __m512 g = _mm512_set1_ps(gain);
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            _mm512_storeu_ps(destL + i, _mm512_mul_ps(_mm512_loadu_ps(sourceL + i), g));
+            _mm512_storeu_ps(destR + i, _mm512_mul_ps(_mm512_loadu_ps(sourceR + i), g));
+        }
+        scalar::scale(destL + i, destR + i, sourceL + i, sourceR + i, gain, numSamples - i);
+    }
+
+    DELAY_TARGET("avx512f")
+    static void panInput(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                         const float* feedbackL, const float* feedbackR,
+                         float panL, float panR, int numSamples) noexcept
+    {
+        __m512 half = _mm512_set1_ps(0.5f);
+        __m512 pl = _mm512_set1_ps(panL);
+        __m512 pr = _mm512_set1_ps(panR);
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            __m512 mono = _mm512_mul_ps(_mm512_add_ps(_mm512_loadu_ps(sourceL + i), _mm512_loadu_ps(sourceR + i)), half);
+            _mm512_storeu_ps(destL + i, _mm512_fmadd_ps(mono, pl, _mm512_loadu_ps(feedbackR + i)));
+            _mm512_storeu_ps(destR + i, _mm512_fmadd_ps(mono, pr, _mm512_loadu_ps(feedbackL + i)));
+        }
+        scalar::panInput(destL + i, destR + i, sourceL + i, sourceR + i,
+                         feedbackL + i, feedbackR + i, panL, panR, numSamples - i);
+    }
+
+    DELAY_TARGET("avx512f")
+    static void mix(float* destL, float* destR, const float* dryL, const float* dryR,
+                    const float* wetL, const float* wetR, float dryGain, float wetGain,
+                    int numSamples) noexcept
+    {
+        __m512 dg = _mm512_set1_ps(dryGain);
+        __m512 wg = _mm512_set1_ps(wetGain);
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            __m512 l = _mm512_fmadd_ps(_mm512_loadu_ps(wetL + i), wg, _mm512_mul_ps(_mm512_loadu_ps(dryL + i), dg));
+            __m512 r = _mm512_fmadd_ps(_mm512_loadu_ps(wetR + i), wg, _mm512_mul_ps(_mm512_loadu_ps(dryR + i), dg));
+            _mm512_storeu_ps(destL + i, l);
+            _mm512_storeu_ps(destR + i, r);
+        }
+        scalar::mix(destL + i, destR + i, dryL + i, dryR + i, wetL + i, wetR + i,
+                    dryGain, wetGain, numSamples - i);
+    }
+
+    DELAY_TARGET("avx512f")
+    static void mixRamped(float* destL, float* destR, const float* dryL, const float* dryR,
+                          const float* wetL, const float* wetR, const float* gains, const float* mixes,
+                          int numSamples) noexcept
+    {
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            __m512 g = _mm512_loadu_ps(gains + i);
+            __m512 m = _mm512_loadu_ps(mixes + i);
+            __m512 dl = _mm512_loadu_ps(dryL + i);
+            __m512 dr = _mm512_loadu_ps(dryR + i);
+            __m512 l = _mm512_mul_ps(_mm512_fmadd_ps(_mm512_sub_ps(_mm512_loadu_ps(wetL + i), dl), m, dl), g);
+            __m512 r = _mm512_mul_ps(_mm512_fmadd_ps(_mm512_sub_ps(_mm512_loadu_ps(wetR + i), dr), m, dr), g);
+            _mm512_storeu_ps(destL + i, l);
+            _mm512_storeu_ps(destR + i, r);
+        }
+        scalar::mixRamped(destL + i, destR + i, dryL + i, dryR + i, wetL + i, wetR + i,
+                          gains + i, mixes + i, numSamples - i);
+    }
+
+    DELAY_TARGET("avx512f")
+    static float peak(const float* left, const float* right, int numSamples) noexcept
+    {
+        __m512i mask = _mm512_set1_epi32(0x7fffffff);
+        __m512i largest = _mm512_setzero_si512();
+        int i = 0;
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            largest = _mm512_max_epi32(largest, _mm512_and_si512(_mm512_castps_si512(_mm512_loadu_ps(left + i)), mask));
+            largest = _mm512_max_epi32(largest, _mm512_and_si512(_mm512_castps_si512(_mm512_loadu_ps(right + i)), mask));
+        }
+        juce::uint32 result = std::max(scalar::peakBits(left + i, right + i, numSamples - i),
+                                       juce::uint32(_mm512_reduce_max_epi32(largest)));
+        return std::bit_cast<float>(result);
+    }
+
+    DELAY_TARGET("avx512f")
+    static void filterStep(VectorKernels::FilterLanes& lanes, const juce::uint32* mask) noexcept
+    {
+        // Sixteen lanes hold the steepest cascade, so this is a single pass.
+        __m512 g = _mm512_load_ps(lanes.g);
+        __m512 s1 = _mm512_load_ps(lanes.s1);
+        __m512 s2 = _mm512_load_ps(lanes.s2);
+        __m512 x = _mm512_loadu_ps(lanes.pipe);
+
+        __m512 hp = _mm512_mul_ps(_mm512_load_ps(lanes.h),
+                                  _mm512_sub_ps(_mm512_fnmadd_ps(s1, _mm512_load_ps(lanes.gR), x), s2));
+        __m512 bp = _mm512_fmadd_ps(hp, g, s1);
+        __m512 lp = _mm512_fmadd_ps(bp, g, s2);
+
+        __m512 newS1 = _mm512_fmadd_ps(hp, g, bp);
+        __m512 newS2 = _mm512_fmadd_ps(bp, g, lp);
+
+        if (mask != nullptr)
+        {
+            __m512i m = _mm512_load_si512(mask);
+            __mmask16 update = _mm512_test_epi32_mask(m, m);
+            newS1 = _mm512_mask_mov_ps(s1, update, newS1);
+            newS2 = _mm512_mask_mov_ps(s2, update, newS2);
+        }
+
+        _mm512_store_ps(lanes.s1, newS1);
+        _mm512_store_ps(lanes.s2, newS2);
+        _mm512_storeu_ps(lanes.pipe + 2, _mm512_fmadd_ps(hp, _mm512_load_ps(lanes.highpassGain),
+                                                         _mm512_mul_ps(lp, _mm512_load_ps(lanes.lowpassGain))));
+    }
+
+    DELAY_TARGET("avx512f")
+    static void delayLanes(VectorKernels::DelayLanes& lanes, float* frames, int numSamples) noexcept
+    {
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i one = _mm512_set1_epi32(1);
+        const __m512i size = _mm512_set1_epi32(lanes.size);
+        const __m512i stride = _mm512_set1_epi32(lanes.stride);
+        const __m512i columns = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        const __m512 half = _mm512_set1_ps(0.5f);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float* frame = frames + i * lanes.stride;
+            float* row = lanes.history + lanes.writeIndex * lanes.stride;
+            __m512i writeIndex = _mm512_set1_epi32(lanes.writeIndex);
+            __m512i numValid = _mm512_set1_epi32(lanes.numValid);
+
+            for (int v = 0; v < lanes.stride; v += 16)
+            {
+                __m512 delay = _mm512_add_ps(_mm512_load_ps(lanes.delay + v), _mm512_load_ps(lanes.delayStep + v));
+                _mm512_store_ps(lanes.delay + v, delay);
+                __m512i delayInt = _mm512_cvttps_epi32(delay);
+                __m512 fraction = _mm512_sub_ps(delay, _mm512_cvtepi32_ps(delayInt));
+
+                __m512i newer = _mm512_sub_epi32(writeIndex, delayInt);
+                newer = _mm512_mask_add_epi32(newer, _mm512_cmplt_epi32_mask(newer, zero), newer, size);
+                __m512i older = _mm512_sub_epi32(newer, one);
+                older = _mm512_mask_add_epi32(older, _mm512_cmplt_epi32_mask(older, zero), older, size);
+
+                const float* column = lanes.history + v;
+                __m512 n = _mm512_i32gather_ps(_mm512_add_epi32(_mm512_mullo_epi32(newer, stride), columns), column, 4);
+                __m512 o = _mm512_i32gather_ps(_mm512_add_epi32(_mm512_mullo_epi32(older, stride), columns), column, 4);
+
+                __mmask16 valid = _mm512_cmple_epi32_mask(delayInt, numValid);
+                __m512 wet = _mm512_maskz_mov_ps(valid, _mm512_fmadd_ps(fraction, _mm512_sub_ps(o, n), n));
+                __m512 crossed = _mm512_permute_ps(wet, _MM_SHUFFLE(2, 3, 0, 1));
+
+                __m512 feedback = _mm512_add_ps(_mm512_load_ps(lanes.feedback + v), _mm512_load_ps(lanes.feedbackStep + v));
+                __m512 dryGain = _mm512_add_ps(_mm512_load_ps(lanes.dryGain + v), _mm512_load_ps(lanes.dryGainStep + v));
+                __m512 wetGain = _mm512_add_ps(_mm512_load_ps(lanes.wetGain + v), _mm512_load_ps(lanes.wetGainStep + v));
+                __m512 pan = _mm512_add_ps(_mm512_load_ps(lanes.pan + v), _mm512_load_ps(lanes.panStep + v));
+                _mm512_store_ps(lanes.feedback + v, feedback);
+                _mm512_store_ps(lanes.dryGain + v, dryGain);
+                _mm512_store_ps(lanes.wetGain + v, wetGain);
+                _mm512_store_ps(lanes.pan + v, pan);
+
+                __m512 x = _mm512_load_ps(frame + v);
+                __m512 mono = _mm512_mul_ps(_mm512_add_ps(x, _mm512_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1))), half);
+                _mm512_store_ps(row + v, _mm512_fmadd_ps(mono, pan,
+                                                         _mm512_mul_ps(crossed, feedback)));
+                _mm512_store_ps(frame + v, _mm512_fmadd_ps(x, dryGain, _mm512_mul_ps(wet, wetGain)));
+            }
+            scalar::advanceLanes(lanes);
+        }
+    }
+}
+
+#endif
+
+//==============================================================================
+#define DELAY_KERNEL_TABLE(ns, isa, width) \
+    { ns::interpolate, ns::interpolateHalf, ns::encodeHalf, ns::scale, ns::panInput, ns::mix, ns::mixRamped, ns::peak, runFilter<ns::filterStep>, \
+      ns::delayLanes, isa, width }
+
+static const VectorKernels scalarKernels = DELAY_KERNEL_TABLE(scalar, VectorKernels::Isa::scalar, 1);
+
+#if JUCE_INTEL
+static const VectorKernels sse2Kernels = DELAY_KERNEL_TABLE(sse2, VectorKernels::Isa::sse2, 4);
+static const VectorKernels avx2Kernels = DELAY_KERNEL_TABLE(avx2, VectorKernels::Isa::avx2, 8);
+static const VectorKernels avx512Kernels = DELAY_KERNEL_TABLE(avx512, VectorKernels::Isa::avx512, 16);
+#endif
+
+const VectorKernels& VectorKernels::get(Isa isa) noexcept
+{
+    jassert(isSupported(isa));
+
+   #if JUCE_INTEL
+    switch (isa)
+    {
+        case Isa::avx512: return avx512Kernels;
+        case Isa::avx2:   return avx2Kernels;
+        case Isa::sse2:   return sse2Kernels;
+        case Isa::scalar: break;
+    }
+   #endif
+    return scalarKernels;
+}
+
+bool VectorKernels::isSupported(Isa isa) noexcept
+{
+    switch (isa)
+    {
+        case Isa::scalar: return true;
+       #if JUCE_INTEL
+        case Isa::sse2:   return juce::SystemStats::hasSSE2();
+        case Isa::avx2:   return juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3();
+        case Isa::avx512: return juce::SystemStats::hasAVX512F();
+       #else
+        default:          break;
+       #endif
+    }
+    return false;
+}
+
+VectorKernels::Isa VectorKernels::select(std::optional<Isa> forced)
+{
+    if (forced.has_value() && isSupported(*forced))
+    {
+        return *forced;
+    }
+
+    auto fromEnvironment = fromName(juce::SystemStats::getEnvironmentVariable("DELAY_KERNELS", {}));
+    if (fromEnvironment.has_value() && isSupported(*fromEnvironment))
+    {
+        return *fromEnvironment;
+    }
+
+    for (auto isa : { Isa::avx512, Isa::avx2, Isa::sse2 })
+    {
+        if (isSupported(isa))
+        {
+            return isa;
+        }
+    }
+    return Isa::scalar;
+}
+
+const char* VectorKernels::getName(Isa isa) noexcept
+{
+    switch (isa)
+    {
+        case Isa::scalar: return "scalar";
+        case Isa::sse2:   return "sse2";
+        case Isa::avx2:   return "avx2";
+        case Isa::avx512: return "avx512";
+    }
+    return "";
+}
+
+std::optional<VectorKernels::Isa> VectorKernels::fromName(const juce::String& name)
+{
+    for (auto isa : { Isa::scalar, Isa::sse2, Isa::avx2, Isa::avx512 })
+    {
+        if (name.equalsIgnoreCase(getName(isa)))
+        {
+            return isa;
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+    VectorKernels.h
+    Created: 19 Oct 2026 2:41:53pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <bit>
+
+// IEEE half-precision conversion with round to nearest even. It gives the
+// same bits as the F16C instructions the wider kernels use, so a buffer
+// written by one path reads back the same through any other.
+namespace HalfFloat
+{
+    inline juce::uint16 fromFloat(float value) noexcept
+    {
+        juce::uint32 bits = std::bit_cast<juce::uint32>(value);
+        juce::uint32 sign = (bits >> 16) & 0x8000u;
+        bits &= 0x7fffffffu;
+
+        juce::uint32 result;
+        if (bits >= 0x47800000u)
+        {
+            // Too large for a half, or already infinite or NaN.
+            result = bits > 0x7f800000u ? 0x7e00u : 0x7c00u;
+        }
+        else if (bits < 0x38800000u)
+        {
+            // Subnormal half. Adding 0.5 lines the mantissa up so the
+            // addition itself does the rounding.
+            result = std::bit_cast<juce::uint32>(std::bit_cast<float>(bits) + 0.5f) - 0x3f000000u;
+        }
+        else
+        {
+            // Rebias the exponent and round the 13 dropped mantissa bits.
+            juce::uint32 mantissaOdd = (bits >> 13) & 1u;
+            result = (bits + 0xc8000fffu + mantissaOdd) >> 13;
+        }
+        return juce::uint16(result | sign);
+    }
+
+    inline float toFloat(juce::uint16 half) noexcept
+    {
+        constexpr juce::uint32 shiftedExponent = 0x7c00u << 13;
+        juce::uint32 bits = juce::uint32(half & 0x7fffu) << 13;
+        juce::uint32 exponent = bits & shiftedExponent;
+        bits += (127u - 15u) << 23;
+
+        if (exponent == shiftedExponent)
+        {
+            bits += (128u - 16u) << 23;
+        }
+        else if (exponent == 0)
+        {
+            bits += 1u << 23;
+            bits = std::bit_cast<juce::uint32>(std::bit_cast<float>(bits) - std::bit_cast<float>(113u << 23));
+        }
+        return std::bit_cast<float>(bits | (juce::uint32(half & 0x8000u) << 16));
+    }
+}
+
+// The block-level hot stages of the delay, compiled once per instruction set.
+// The processor picks a table in prepareToPlay and calls through it, so one
+// binary runs the widest path the CPU supports. The scalar table is the
+// reference the other paths are verified against.
+struct VectorKernels
+{
+    enum class Isa
+    {
+        scalar,
+        sse2,
+        avx2,
+        avx512,
+    };
+
+    // A cascade of state variable filters with one lane per channel and
+    // section: lane 2 * section + channel. The sections are pipelined, so
+    // while section 0 takes sample n, section 1 works on sample n - 1, and
+    // so on. That turns the serial cascade into one vector operation per
+    // sample, whatever the number of sections, as long as the lanes fit.
+    struct FilterLanes
+    {
+        static constexpr int maxLanes = 16;
+        int numLanes = 2;
+
+        // Coefficients of the TPT structure, with gR = g + 1 / resonance.
+        // The output is highpass * highpassGain + lowpass * lowpassGain.
+        alignas(64) float g[maxLanes] {};
+        alignas(64) float gR[maxLanes] {};
+        alignas(64) float h[maxLanes] {};
+        alignas(64) float highpassGain[maxLanes] {};
+        alignas(64) float lowpassGain[maxLanes] {};
+
+        alignas(64) float s1[maxLanes] {};
+        alignas(64) float s2[maxLanes] {};
+
+        // pipe[lane] is the input of a lane and pipe[lane + 2] its output,
+        // which is the input of the next section on the following sample.
+        alignas(64) float pipe[maxLanes + 2] {};
+        alignas(64) juce::uint32 mask[maxLanes] {};
+    };
+
+    // Independent stereo delays side by side, one voice per channel: voice
+    // 2 * lane + channel. The history holds one frame of all voices per
+    // sample, so every read and write of a sample touches one row, and a
+    // register advances as many voices as it has lanes. The stride is a
+    // multiple of 16, which keeps every path on whole registers, and the
+    // voices past the used ones stay silent.
+    struct DelayLanes
+    {
+        static constexpr int maxVoices = 32;
+        int stride = 16;
+
+        // size rows of stride floats. Rows older than numValid samples are
+        // treated as silent, which makes a reset take constant time.
+        float* history = nullptr;
+        int size = 0;
+        int writeIndex = 0;
+        int numValid = 0;
+
+        // Each voice ramps its delay in samples, its feedback, its pan and
+        // its gains by one step per sample. What goes into the history is the
+        // mono sum of the lane times pan, plus feedback times the wet signal
+        // of the other channel. The output is input * dryGain + wet * wetGain.
+        alignas(64) float delay[maxVoices] {};
+        alignas(64) float delayStep[maxVoices] {};
+        alignas(64) float feedback[maxVoices] {};
+        alignas(64) float feedbackStep[maxVoices] {};
+        alignas(64) float dryGain[maxVoices] {};
+        alignas(64) float dryGainStep[maxVoices] {};
+        alignas(64) float wetGain[maxVoices] {};
+        alignas(64) float wetGainStep[maxVoices] {};
+        alignas(64) float pan[maxVoices] {};
+        alignas(64) float panStep[maxVoices] {};
+    };
+
+    // dest = newer + fraction * (older - newer), the linear interpolation
+    // between two neighbouring samples of the delay buffer.
+    void (*interpolate)(float* dest, const float* newer, const float* older,
+                        float fraction, int numSamples) noexcept;
+
+    // Like interpolate, but the buffer holds half floats.
+    void (*interpolateHalf)(float* dest, const juce::uint16* newer, const juce::uint16* older,
+                            float fraction, int numSamples) noexcept;
+
+    // Converts a block to half floats for the compact delay buffers.
+    void (*encodeHalf)(juce::uint16* dest, const float* source, int numSamples) noexcept;
+
+    // dest = source * gain, for both channels.
+    void (*scale)(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                  float gain, int numSamples) noexcept;
+
+    // Pans the mono sum of the input and adds the crossed-over feedback.
+    void (*panInput)(float* destL, float* destR, const float* sourceL, const float* sourceR,
+                     const float* feedbackL, const float* feedbackR,
+                     float panL, float panR, int numSamples) noexcept;
+
+    // dest = dry * dryGain + wet * wetGain, for both channels. dest may be dry.
+    void (*mix)(float* destL, float* destR, const float* dryL, const float* dryR,
+                const float* wetL, const float* wetR, float dryGain, float wetGain,
+                int numSamples) noexcept;
+
+    // Like mix, but with a gain and a mix amount per sample:
+    // dest = (dry + (wet - dry) * mixes) * gains. dest may be dry.
+    void (*mixRamped)(float* destL, float* destR, const float* dryL, const float* dryR,
+                      const float* wetL, const float* wetR, const float* gains, const float* mixes,
+                      int numSamples) noexcept;
+
+    // The largest magnitude in either channel. Not finite if any sample is
+    // infinite or NaN, which a floating-point maximum would not guarantee.
+    float (*peak)(const float* left, const float* right, int numSamples) noexcept;
+
+    // Runs a block through the filter cascade, in place.
+    void (*filter)(FilterLanes& lanes, float* left, float* right, int numSamples) noexcept;
+
+    // Runs numSamples frames of stride floats through the delay lanes, in
+    // place. A delay must stay between 1 and size - 2 samples.
+    void (*delayLanes)(DelayLanes& lanes, float* frames, int numSamples) noexcept;
+
+    Isa isa;
+
+    // The number of float lanes in one register. Filter lane counts are
+    // rounded up to this.
+    int laneWidth;
+
+    static const VectorKernels& get(Isa isa) noexcept;
+    static bool isSupported(Isa isa) noexcept;
+
+    // Returns the forced path if the CPU supports it. Otherwise the
+    // DELAY_KERNELS environment variable is honoured, and without it the
+    // widest supported path is used.
+    static Isa select(std::optional<Isa> forced);
+
+    static const char* getName(Isa isa) noexcept;
+    static std::optional<Isa> fromName(const juce::String& name);
+};
@@ -0,0 +1,127 @@
+/*
+  ==============================================================================
+
+    WaveformDisplay.cpp
+    Created: 19 Oct 2026 7:48:13pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "WaveformDisplay.h"
+#include "LookAndFeel.h"
+#include "Trace.h"
+
+WaveformDisplay::WaveformDisplay(WaveformFeed& feed_)
+    : feed(feed_), incoming(size_t(WaveformFeed::columnsPerSecond))
+{
+    setOpaque(true);
+    feed.setActive(true);
+    startTimerHz(framesPerSecond);
+}
+
+WaveformDisplay::~WaveformDisplay()
+{
+    feed.setActive(false);
+}
+
+void WaveformDisplay::paint(juce::Graphics& g)
+{
+    g.drawImageAt(history, 0, 0);
+
+    float width = float(getWidth());
+    float height = float(getHeight());
+
+    auto drawHead = [&](float columnsBehind, juce::Colour colour)
+    {
+        if (columnsBehind >= 0.0f && columnsBehind < width)
+        {
+            g.setColour(colour);
+            g.fillRect(width - 1.0f - columnsBehind, 0.0f, 1.0f, height);
+        }
+    };
+    drawHead(0.0f, Colors::Waveform::writeHead);
+    drawHead(heads.forward, Colors::Waveform::forwardHead);
+    drawHead(heads.reverse, Colors::Waveform::reverseHead);
+
+    g.setColour(Colors::Group::outline);
+    g.drawRect(getLocalBounds());
+}
+
+void WaveformDisplay::resized()
+{
+    // Starts over empty. Stretching the old columns would put them at the
+    // wrong time. A software image keeps the scroll a plain memory move on
+    // platforms where native images live on the GPU.
+    history = juce::Image(juce::Image::RGB, std::max(1, getWidth()), std::max(1, getHeight()), false,
+                          juce::SoftwareImageType());
+    clearHistory();
+}
+
+void WaveformDisplay::timerCallback()
+{
+    DELAY_TRACE_ZONE("waveform scroll");
+
+    // Usually one or two columns, more after a stall. Each pop takes at most
+    // a second's worth, the FIFO holds the rest until the next frame.
+    int numColumns = feed.pop(incoming.data(), int(incoming.size()));
+    auto newHeads = feed.getHeads();
+
+    if (numColumns == 0 && newHeads.forward == heads.forward && newHeads.reverse == heads.reverse)
+    {
+        return;
+    }
+
+    heads = newHeads;
+    drawColumns(incoming.data(), numColumns);
+    repaint();
+}
+
+void WaveformDisplay::drawColumns(const WaveformFeed::Column* columns, int numColumns)
+{
+    int width = history.getWidth();
+    int height = history.getHeight();
+
+    // Columns that would scroll straight out again are skipped.
+    int shift = std::min(numColumns, width);
+    columns += numColumns - shift;
+
+    if (shift == 0)
+    {
+        return;
+    }
+    if (shift < width)
+    {
+        history.moveImageSection(0, 0, shift, 0, width - shift, height);
+    }
+
+    juce::Graphics g(history);
+    g.setColour(Colors::Waveform::background);
+    g.fillRect(width - shift, 0, shift, height);
+
+    float centre = float(height) * 0.5f;
+    float scale = float(height) * 0.45f;
+
+    for (int i = 0; i < shift; ++i)
+    {
+        const auto& column = columns[i];
+        float x = float(width - shift + i);
+
+        if (column.segmentStart)
+        {
+            g.setColour(Colors::Waveform::segmentStart);
+            g.fillRect(x, 0.0f, 1.0f, float(height));
+        }
+
+        float top = centre - juce::jlimit(-1.0f, 1.0f, column.max) * scale;
+        float bottom = centre - juce::jlimit(-1.0f, 1.0f, column.min) * scale;
+        g.setColour(Colors::Waveform::peak);
+        g.fillRect(x, top, 1.0f, std::max(1.0f, bottom - top));
+    }
+}
+
+void WaveformDisplay::clearHistory()
+{
+    juce::Graphics g(history);
+    g.fillAll(Colors::Waveform::background);
+}
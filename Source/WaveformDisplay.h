@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+
+    WaveformDisplay.h
+    Created: 19 Oct 2026 7:48:13pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "WaveformFeed.h"
+
+// Scrolls the delay history from right to left. The write head sits at the
+// right edge, lines mark where the forward and reverse heads read, and a
+// shaded column marks where each reverse segment began.
+//
+// Columns are drawn into an image once, as they arrive. Every frame the
+// image moves left by the number of new columns and only those get drawn,
+// so a frame costs the same however wide the display is.
+class WaveformDisplay : public juce::Component, private juce::Timer
+{
+public:
+    explicit WaveformDisplay(WaveformFeed& feed);
+    ~WaveformDisplay() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    static constexpr int framesPerSecond = 60;
+
+    void timerCallback() override;
+    void drawColumns(const WaveformFeed::Column* columns, int numColumns);
+    void clearHistory();
+
+    WaveformFeed& feed;
+    juce::Image history;
+    std::vector<WaveformFeed::Column> incoming;
+    WaveformFeed::Heads heads;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformDisplay)
+};
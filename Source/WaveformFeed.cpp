@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    WaveformFeed.cpp
+    Created: 19 Oct 2026 7:48:13pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "WaveformFeed.h"
+
+void WaveformFeed::prepare(double sampleRate) noexcept
+{
+    samplesPerColumn = std::max(1, juce::roundToInt(sampleRate / columnsPerSecond));
+    wasActive = false;
+}
+
+void WaveformFeed::push(const float* left, const float* right, int numSamples, int segmentAge,
+                        float forwardDelay, float reverseDelay) noexcept
+{
+    if (!isActive())
+    {
+        wasActive = false;
+        return;
+    }
+
+    // Starts a fresh column when a display comes back, the one left over
+    // from before is long out of date.
+    if (!wasActive)
+    {
+        current = {};
+        samplesInColumn = 0;
+        lastSegmentStart = -1;
+        wasActive = true;
+    }
+
+    // The phase of a segment is fractional, so the start can come out one
+    // sample apart from one block to the next.
+    auto segmentStart = segmentAge >= 0 ? position + numSamples - 1 - segmentAge : juce::int64(-1);
+    bool newSegment = segmentStart >= position && std::abs(segmentStart - lastSegmentStart) > 1;
+    if (segmentStart >= 0)
+    {
+        lastSegmentStart = segmentStart;
+    }
+
+    int sample = 0;
+    while (sample < numSamples)
+    {
+        int length = std::min(numSamples - sample, samplesPerColumn - samplesInColumn);
+
+        if (left != nullptr)
+        {
+            auto rangeL = juce::FloatVectorOperations::findMinAndMax(left + sample, length);
+            auto rangeR = juce::FloatVectorOperations::findMinAndMax(right + sample, length);
+            current.min = std::min({ current.min, rangeL.getStart(), rangeR.getStart() });
+            current.max = std::max({ current.max, rangeL.getEnd(), rangeR.getEnd() });
+        }
+
+        auto columnPosition = position + sample;
+        if (newSegment && segmentStart >= columnPosition && segmentStart < columnPosition + length)
+        {
+            current.segmentStart = true;
+        }
+
+        sample += length;
+        samplesInColumn += length;
+
+        if (samplesInColumn == samplesPerColumn)
+        {
+            // A full FIFO means the display has stopped reading, so the
+            // column is dropped.
+            auto scope = fifo.write(1);
+            if (scope.blockSize1 > 0)
+            {
+                columns[size_t(scope.startIndex1)] = current;
+            }
+            current = {};
+            samplesInColumn = 0;
+        }
+    }
+    position += numSamples;
+
+    float samplesToColumns = 1.0f / float(samplesPerColumn);
+    forwardHead.store(forwardDelay >= 0.0f ? forwardDelay * samplesToColumns : -1.0f, std::memory_order_relaxed);
+    reverseHead.store(reverseDelay >= 0.0f ? reverseDelay * samplesToColumns : -1.0f, std::memory_order_relaxed);
+}
+
+int WaveformFeed::pop(Column* dest, int maxColumns) noexcept
+{
+    int numRead = 0;
+    auto scope = fifo.read(std::min(maxColumns, fifo.getNumReady()));
+    scope.forEach([&](int index)
+    {
+        dest[numRead++] = columns[size_t(index)];
+    });
+    return numRead;
+}
@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    WaveformFeed.h
+    Created: 19 Oct 2026 7:48:13pm
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Carries a picture of the delay history from the audio thread to the
+// editor.
+//
+// The audio thread reduces what goes into the history to one min/max pair
+// per column, a fixed number of columns per second, and pushes the columns
+// into a lock-free FIFO with one writer and one reader. A column is flagged
+// when a reverse segment starts in it. The heads are published once per
+// block. While no display is watching, the audio thread does nothing.
+class WaveformFeed
+{
+public:
+    struct Column
+    {
+        float min = 0.0f;
+        float max = 0.0f;
+        bool segmentStart = false;
+    };
+
+    // How far behind the write position each head reads, in columns.
+    // Negative while the head is not playing.
+    struct Heads
+    {
+        float forward = -1.0f;
+        float reverse = -1.0f;
+    };
+
+    static constexpr int columnsPerSecond = 100;
+
+    // Audio stopped.
+    void prepare(double sampleRate) noexcept;
+
+    // Message thread. Displays switch the feed on while they are showing.
+    void setActive(bool shouldBeActive) noexcept
+    {
+        active.store(shouldBeActive);
+    }
+
+    bool isActive() const noexcept
+    {
+        return active.load(std::memory_order_relaxed);
+    }
+
+    // Audio thread, once per block. The channels are what went into the
+    // history this block, or nullptr for silence. The current reverse
+    // segment started segmentAge samples before the last one, or not at
+    // all if that is negative. The head delays are in samples.
+    void push(const float* left, const float* right, int numSamples, int segmentAge,
+              float forwardDelay, float reverseDelay) noexcept;
+
+    // Message thread. Returns the number of columns read, oldest first.
+    int pop(Column* dest, int maxColumns) noexcept;
+
+    Heads getHeads() const noexcept
+    {
+        return { forwardHead.load(std::memory_order_relaxed), reverseHead.load(std::memory_order_relaxed) };
+    }
+
+private:
+    // Ten seconds of columns, so a display that misses a few frames
+    // catches up instead of losing them.
+    static constexpr int capacity = 1024;
+
+    juce::AbstractFifo fifo { capacity };
+    std::array<Column, capacity> columns;
+
+    // Audio thread only.
+    Column current;
+    int samplesInColumn = 0;
+    int samplesPerColumn = 441;
+    juce::int64 position = 0;
+    juce::int64 lastSegmentStart = -1;
+    bool wasActive = false;
+
+    std::atomic<float> forwardHead { -1.0f };
+    std::atomic<float> reverseHead { -1.0f };
+    std::atomic<bool> active { false };
+};
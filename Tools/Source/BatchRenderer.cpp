@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.cpp
+    Created: 19 Oct 2026 10:31:17am
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "BatchRenderer.h"
+#include "../../Source/PluginProcessor.h"
+
+// Offline renders have no host, so this stands in for the transport.
+class OfflinePlayHead : public juce::AudioPlayHead
+{
+public:
+    explicit OfflinePlayHead(double bpm_) : bpm(bpm_) {}
+
+    void setPosition(juce::int64 samplePosition) noexcept
+    {
+        position = samplePosition;
+    }
+
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        PositionInfo info;
+        info.setBpm(bpm);
+        info.setIsPlaying(true);
+        info.setTimeInSamples(position);
+        return info;
+    }
+
+private:
+    double bpm;
+    juce::int64 position = 0;
+};
+
+// Every worker owns one processor and keeps pulling the next unclaimed file
+// until the list is exhausted, so the load balances itself across cores.
+class BatchRenderer::Worker : public juce::Thread
+{
+public:
+    Worker(BatchRenderer& owner_, int index)
+        : juce::Thread("Render worker " + juce::String(index)), owner(owner_)
+    {
+        formats.registerBasicFormats();
+    }
+
+    void run() override
+    {
+        for (int job = owner.nextJob++; job < owner.jobs.size() && !threadShouldExit(); job = owner.nextJob++)
+        {
+            const auto& file = owner.jobs.getReference(job);
+            juce::String error;
+            bool success = owner.renderFile(processor, formats, file, error);
+
+            if (!success)
+            {
+                ++owner.numFailed;
+            }
+
+            const juce::ScopedLock lock(owner.printLock);
+            std::cout << (success ? "rendered " : "failed   ") << file.getFileName()
+                      << (success ? "" : " (" + error + ")") << std::endl;
+        }
+    }
+
+private:
+    BatchRenderer& owner;
+    DelayAudioProcessor processor;
+    juce::AudioFormatManager formats;
+};
+
+BatchRenderer::BatchRenderer(Options options_)
+    : options(std::move(options_))
+{
+}
+
+bool BatchRenderer::loadPreset(const juce::File& file, juce::MemoryBlock& destState)
+{
+    juce::MemoryBlock data;
+    if (!file.loadFileAsData(data))
+    {
+        return false;
+    }
+
+    // Presets exported as XML are wrapped into the binary state format here,
+    // so the processor always loads them through setStateInformation.
+    if (data.toString().trimStart().startsWithChar('<'))
+    {
+        auto xml = juce::parseXML(data.toString());
+        if (xml == nullptr)
+        {
+            return false;
+        }
+        destState.reset();
+        juce::AudioProcessor::copyXmlToBinary(*xml, destState);
+        return true;
+    }
+
+    destState = data;
+    return true;
+}
+
+int BatchRenderer::render(const juce::Array<juce::File>& files)
+{
+    jobs = files;
+    nextJob = 0;
+    numFailed = 0;
+
+    options.outputFolder.createDirectory();
+
+    int numWorkers = juce::jlimit(1, std::max(1, files.size()), options.numThreads);
+    juce::OwnedArray<Worker> workers;
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        workers.add(new Worker(*this, i));
+    }
+
+    for (auto* worker : workers)
+    {
+        worker->startThread();
+    }
+    for (auto* worker : workers)
+    {
+        worker->waitForThreadToExit(-1);
+    }
+
+    return numFailed;
+}
+
+bool BatchRenderer::renderFile(DelayAudioProcessor& processor, juce::AudioFormatManager& formats,
+                               const juce::File& file, juce::String& error)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    // WAV and AIFF are mapped into memory instead of being streamed.
+    if (auto* format = formats.findFormatForFileExtension(file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+        if (mapped != nullptr && mapped->mapEntireFile())
+        {
+            reader = std::move(mapped);
+        }
+    }
+    if (reader == nullptr)
+    {
+        reader.reset(formats.createReaderFor(file));
+    }
+    if (reader == nullptr)
+    {
+        error = "unsupported or unreadable file";
+        return false;
+    }
+
+    auto outputFile = options.outputFolder.getChildFile(file.getFileNameWithoutExtension() + ".wav");
+    outputFile.deleteFile();
+
+    auto stream = std::make_unique<juce::FileOutputStream>(outputFile);
+    if (stream->failedToOpen())
+    {
+        error = "cannot write " + outputFile.getFullPathName();
+        return false;
+    }
+
+    int bitsPerSample = int(reader->bitsPerSample);
+    if (bitsPerSample != 16 && bitsPerSample != 24 && bitsPerSample != 32)
+    {
+        bitsPerSample = 24;
+    }
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(
+        wav.createWriterFor(stream.get(), reader->sampleRate, 2, bitsPerSample, {}, 0));
+    if (writer == nullptr)
+    {
+        error = "cannot create WAV writer";
+        return false;
+    }
+    stream.release();
+
+    // Loading the state and preparing again puts the processor back into the
+    // same initial state for every file, which keeps the output independent
+    // of the file order and the number of workers.
+    double sampleRate = reader->sampleRate;
+    OfflinePlayHead playHead(options.bpm);
+    processor.setPlayHead(&playHead);
+    processor.setPlayConfigDetails(2, 2, sampleRate, options.blockSize);
+    processor.setNonRealtime(true);
+    if (options.state.getSize() > 0)
+    {
+        processor.setStateInformation(options.state.getData(), int(options.state.getSize()));
+    }
+    if (options.compactStorage)
+    {
+        processor.setCompactStorage(true);
+    }
+    processor.prepareToPlay(sampleRate, options.blockSize);
+
+    // The processor delays everything by its latency, so that much more is
+    // rendered and dropped from the start, which lines the file up with the
+    // input like a host with delay compensation would.
+    juce::int64 latency = processor.getLatencySamples();
+    juce::int64 inputLength = reader->lengthInSamples;
+    juce::int64 totalLength = inputLength + juce::int64(options.tailSeconds * sampleRate) + latency;
+
+    int chunkSize = options.blockSize * 32;
+    juce::AudioBuffer<float> chunk(2, chunkSize);
+    juce::MidiBuffer midi;
+    bool success = true;
+
+    for (juce::int64 position = 0; position < totalLength; position += chunkSize)
+    {
+        int numSamples = int(std::min<juce::int64>(chunkSize, totalLength - position));
+        chunk.clear();
+
+        if (position < inputLength)
+        {
+            int numToRead = int(std::min<juce::int64>(numSamples, inputLength - position));
+            reader->read(&chunk, 0, numToRead, position, true, true);
+            if (reader->numChannels == 1)
+            {
+                chunk.copyFrom(1, 0, chunk, 0, 0, numToRead);
+            }
+        }
+
+        for (int start = 0; start < numSamples; start += options.blockSize)
+        {
+            int blockLength = std::min(options.blockSize, numSamples - start);
+            juce::AudioBuffer<float> block(chunk.getArrayOfWritePointers(), 2, start, blockLength);
+            playHead.setPosition(position + start);
+            processor.processBlock(block, midi);
+        }
+
+        int skip = int(juce::jlimit<juce::int64>(0, numSamples, latency - position));
+        if (skip < numSamples && !writer->writeFromAudioSampleBuffer(chunk, skip, numSamples - skip))
+        {
+            error = "write failed";
+            success = false;
+            break;
+        }
+    }
+
+    processor.releaseResources();
+    processor.setPlayHead(nullptr);
+    return success;
+}
@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    BatchRenderer.h
+    Created: 19 Oct 2026 10:31:17am
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+class DelayAudioProcessor;
+
+class BatchRenderer
+{
+public:
+    struct Options
+    {
+        juce::File outputFolder;
+        juce::MemoryBlock state;
+        int numThreads = 1;
+        int blockSize = 512;
+        double bpm = 120.0;
+        double tailSeconds = 0.0;
+
+        // Forces half-float delay buffers, whatever the preset says.
+        bool compactStorage = false;
+    };
+
+    explicit BatchRenderer(Options options);
+
+    // Renders every file and returns the number of files that failed.
+    int render(const juce::Array<juce::File>& files);
+
+    // Reads a preset saved either as the plugin's binary state or as XML.
+    static bool loadPreset(const juce::File& file, juce::MemoryBlock& destState);
+
+private:
+    class Worker;
+
+    bool renderFile(DelayAudioProcessor& processor, juce::AudioFormatManager& formats,
+                    const juce::File& file, juce::String& error);
+
+    Options options;
+    juce::Array<juce::File> jobs;
+    std::atomic<int> nextJob { 0 };
+    std::atomic<int> numFailed { 0 };
+    juce::CriticalSection printLock;
+};
@@ -0,0 +1,571 @@
+/*
+  ==============================================================================
+
+    Benchmark.cpp
+    Created: 19 Oct 2026 9:12:05am
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/Trace.h"
+
+const std::array<Benchmark::Preset, 4> Benchmark::presets =
+{{
+    { "forward",       false, false,  250.0f,   50.0f },
+    { "reverse",       true,  false,  250.0f,   50.0f },
+    { "tempo sync",    false, true,   250.0f,   50.0f },
+    { "high feedback", true,  false, 1000.0f,  100.0f },
+}};
+
+const char* Benchmark::getSignalName(Signal signal)
+{
+    switch (signal)
+    {
+        case Benchmark::Signal::impulse: return "impulse";
+        case Benchmark::Signal::sweep:   return "sweep";
+        case Benchmark::Signal::noise:   return "noise";
+    }
+    return "";
+}
+
+void Benchmark::setParameter(DelayAudioProcessor& processor, const juce::ParameterID& id, float value)
+{
+    auto* param = processor.apvts.getParameter(id.getParamID());
+    jassert(param != nullptr);
+    param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+Benchmark::Benchmark(double sampleRate_, int blockSize_)
+    : sampleRate(sampleRate_), blockSize(blockSize_)
+{
+}
+
+void Benchmark::fillSignal(juce::AudioBuffer<float>& buffer, Signal signal, double sampleRate)
+{
+    buffer.clear();
+    int numSamples = buffer.getNumSamples();
+
+    if (signal == Signal::impulse)
+    {
+        // One impulse every half second, so feedback tails overlap.
+        int spacing = int(sampleRate * 0.5);
+        for (int i = 0; i < numSamples; i += spacing)
+        {
+            buffer.setSample(0, i, 1.0f);
+            buffer.setSample(1, i, 1.0f);
+        }
+    }
+    else if (signal == Signal::sweep)
+    {
+        // Logarithmic sine sweep from 20 Hz to 20 kHz.
+        double duration = numSamples / sampleRate;
+        double k = std::log(20000.0 / 20.0);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double t = i / sampleRate;
+            double phase = juce::MathConstants<double>::twoPi * 20.0 * duration / k
+                         * (std::exp(t * k / duration) - 1.0);
+            float value = 0.5f * float(std::sin(phase));
+            buffer.setSample(0, i, value);
+            buffer.setSample(1, i, value);
+        }
+    }
+    else
+    {
+        // Fixed seed, so every run sees the same noise.
+        juce::Random random(1234);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            buffer.setSample(0, i, random.nextFloat() - 0.5f);
+            buffer.setSample(1, i, random.nextFloat() - 0.5f);
+        }
+    }
+}
+
+void Benchmark::applyPreset(DelayAudioProcessor& processor, const Preset& preset)
+{
+    setParameter(processor, reverseDelayParamID, preset.reverse ? 1.0f : 0.0f);
+    setParameter(processor, tempoSyncParamID, preset.tempoSync ? 1.0f : 0.0f);
+    setParameter(processor, delayTimeParamID, preset.delayTime);
+    setParameter(processor, feedbackParamID, preset.feedback);
+}
+
+Benchmark::Result Benchmark::render(const Preset& preset, VectorKernels::Isa isa,
+                                   const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output)
+{
+    DelayAudioProcessor processor;
+    processor.forceKernels(isa);
+    processor.setCompactStorage(compactStorage);
+    processor.setDecimatedWet(decimatedWet);
+    applyPreset(processor, preset);
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    Result result;
+    output.setSize(2, input.getNumSamples(), false, false, true);
+
+    for (int start = 0; start < input.getNumSamples(); start += blockSize)
+    {
+        int numSamples = std::min(blockSize, input.getNumSamples() - start);
+        buffer.setSize(2, numSamples, false, false, true);
+        buffer.copyFrom(0, 0, input, 0, start, numSamples);
+        buffer.copyFrom(1, 0, input, 1, start, numSamples);
+
+        auto ticks = juce::Time::getHighResolutionTicks();
+        processor.processBlock(buffer, midi);
+        result.secondsElapsed += juce::Time::highResolutionTicksToSeconds(
+            juce::Time::getHighResolutionTicks() - ticks);
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax(buffer.getReadPointer(channel), numSamples);
+            result.finite = result.finite && std::isfinite(range.getStart()) && std::isfinite(range.getEnd());
+            result.peak = std::max({ result.peak, std::abs(range.getStart()), std::abs(range.getEnd()) });
+            output.copyFrom(channel, start, buffer, channel, 0, numSamples);
+        }
+    }
+
+    processor.releaseResources();
+    return result;
+}
+
+void Benchmark::measureEditorOpen()
+{
+    DelayAudioProcessor processor;
+
+    auto openEditor = [&processor](std::unique_ptr<juce::AudioProcessorEditor>& editor)
+    {
+        auto ticks = juce::Time::getHighResolutionTicks();
+        editor.reset(processor.createEditor());
+        editor->createComponentSnapshot(editor->getLocalBounds());
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - ticks) * 1000.0;
+    };
+
+    std::unique_ptr<juce::AudioProcessorEditor> first, other;
+    double cold = openEditor(first);
+
+    constexpr int numWarm = 10;
+    double warm = 0.0;
+    for (int i = 0; i < numWarm; ++i)
+    {
+        warm += openEditor(other);
+        other.reset();
+    }
+
+    first.reset();
+    double released = openEditor(first);
+    first.reset();
+
+    std::cout << "editor open " << juce::String(cold, 2) << " ms cold, "
+              << juce::String(warm / numWarm, 2) << " ms with shared resources, "
+              << juce::String(released, 2) << " ms after the last editor closed" << std::endl;
+}
+
+void Benchmark::measureTraceOverhead([[maybe_unused]] const juce::AudioBuffer<float>& input)
+{
+   #if DELAY_TRACING
+    // Restarting would drop what a --trace capture has recorded so far.
+    if (Trace::isRunning())
+    {
+        return;
+    }
+
+    juce::AudioBuffer<float> output;
+    auto isa = VectorKernels::select(onlyKernels);
+    for (const auto& preset : { presets[0], presets[1] })
+    {
+        double off = render(preset, isa, input, output).secondsElapsed;
+        Trace::start();
+        double on = render(preset, isa, input, output).secondsElapsed;
+        Trace::stop();
+
+        std::cout << "tracing " << juce::String(preset.name).paddedRight(' ', 9)
+                  << juce::String((on / std::max(off, 1e-9) - 1.0) * 100.0, 2) << " % slower with a capture running" << std::endl;
+    }
+   #endif
+}
+
+void Benchmark::measureCaptureCost(const juce::AudioBuffer<float>& input)
+{
+    DelayAudioProcessor processor;
+    processor.setCompactStorage(compactStorage);
+    processor.setDecimatedWet(decimatedWet);
+    applyPreset(processor, presets[0]);
+    processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    auto file = juce::File::createTempFile(".wav");
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+
+    double secondsBefore = 0.0, secondsDuring = 0.0, slowestDuring = 0.0;
+    int blocksBefore = 0, blocksDuring = 0;
+    bool requested = false;
+
+    for (int start = 0; start + blockSize <= input.getNumSamples(); start += blockSize)
+    {
+        // The first half fills the history, the second copies it out.
+        if (!requested && start >= input.getNumSamples() / 2)
+        {
+            requested = processor.captureHistory(file, DelayAudioProcessor::maxCaptureSeconds);
+        }
+
+        buffer.copyFrom(0, 0, input, 0, start, blockSize);
+        buffer.copyFrom(1, 0, input, 1, start, blockSize);
+
+        bool capturing = processor.isCapturingHistory();
+        auto ticks = juce::Time::getHighResolutionTicks();
+        processor.processBlock(buffer, midi);
+        double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - ticks);
+
+        if (capturing)
+        {
+            secondsDuring += elapsed;
+            slowestDuring = std::max(slowestDuring, elapsed);
+            ++blocksDuring;
+        }
+        else if (!requested)
+        {
+            secondsBefore += elapsed;
+            ++blocksBefore;
+        }
+    }
+
+    // The writer thread may still be busy with the file.
+    for (int i = 0; i < 100 && processor.isCapturingHistory(); ++i)
+    {
+        juce::Thread::sleep(50);
+    }
+    processor.releaseResources();
+    file.deleteFile();
+
+    if (blocksBefore > 0 && blocksDuring > 0)
+    {
+        std::cout << "history capture " << juce::String(secondsBefore * 1e6 / blocksBefore, 2) << " us per block before, "
+                  << juce::String(secondsDuring * 1e6 / blocksDuring, 2) << " us while capturing ("
+                  << blocksDuring << " blocks, slowest " << juce::String(slowestDuring * 1e6, 2) << " us)" << std::endl;
+    }
+}
+
+void Benchmark::measurePipeline(const juce::AudioBuffer<float>& input)
+{
+    int numBlocks = input.getNumSamples() / blockSize;
+    if (numBlocks < 2)
+    {
+        return;
+    }
+
+    // The busy wait stands in for the rest of the host's graph, which runs
+    // on the same thread between two callbacks of this instance.
+    auto renderWithHostLoad = [&](bool pipelined, double hostSeconds, juce::AudioBuffer<float>& output)
+    {
+        DelayAudioProcessor processor;
+        processor.setCompactStorage(compactStorage);
+        processor.setDecimatedWet(decimatedWet);
+        processor.setPipelined(pipelined);
+        applyPreset(processor, presets[3]);
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        output.setSize(2, numBlocks * blockSize, false, false, true);
+        auto hostTicks = juce::int64(hostSeconds * double(juce::Time::getHighResolutionTicksPerSecond()));
+
+        auto startTicks = juce::Time::getHighResolutionTicks();
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            int start = block * blockSize;
+            buffer.copyFrom(0, 0, input, 0, start, blockSize);
+            buffer.copyFrom(1, 0, input, 1, start, blockSize);
+
+            processor.processBlock(buffer, midi);
+
+            auto hostEnd = juce::Time::getHighResolutionTicks() + hostTicks;
+            while (juce::Time::getHighResolutionTicks() < hostEnd) {}
+
+            output.copyFrom(0, start, buffer, 0, 0, blockSize);
+            output.copyFrom(1, start, buffer, 1, 0, blockSize);
+        }
+        double elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+        processor.releaseResources();
+        return elapsed / numBlocks;
+    };
+
+    juce::AudioBuffer<float> serialOutput, pipelinedOutput;
+    double engineTime = renderWithHostLoad(false, 0.0, serialOutput);
+    double serialTime = renderWithHostLoad(false, engineTime, serialOutput);
+    double pipelinedTime = renderWithHostLoad(true, engineTime, pipelinedOutput);
+
+    bool matches = true;
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        for (int i = blockSize; i < pipelinedOutput.getNumSamples(); ++i)
+        {
+            matches = matches && pipelinedOutput.getSample(channel, i) == serialOutput.getSample(channel, i - blockSize);
+        }
+    }
+
+    std::cout << "pipeline " << juce::String(serialTime * 1e6, 2) << " us per block serial, "
+              << juce::String(pipelinedTime * 1e6, 2) << " us pipelined, with "
+              << juce::String(engineTime * 1e6, 2) << " us of other host work per block, output "
+              << (matches ? "matches one block later" : "DIFFERS") << std::endl;
+}
+
+void Benchmark::measureLanes(const juce::AudioBuffer<float>& input)
+{
+    constexpr int numLanes = 16;
+    int numBlocks = input.getNumSamples() / blockSize;
+    if (numBlocks < 1)
+    {
+        return;
+    }
+
+    // Every lane gets the same noise, which makes no difference to the work.
+    auto renderLanes = [&](VectorKernels::Isa isa, int numInstances, int numChannels)
+    {
+        std::vector<std::unique_ptr<DelayAudioProcessor>> processors;
+        for (int instance = 0; instance < numInstances; ++instance)
+        {
+            auto& processor = processors.emplace_back(std::make_unique<DelayAudioProcessor>());
+            processor->forceKernels(isa);
+            processor->setCompactStorage(compactStorage);
+            applyPreset(*processor, presets[0]);
+            processor->setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+            processor->prepareToPlay(sampleRate, blockSize);
+        }
+
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        double elapsed = 0.0;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (auto& processor : processors)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    buffer.copyFrom(channel, 0, input, channel % 2, block * blockSize, blockSize);
+                }
+
+                auto ticks = juce::Time::getHighResolutionTicks();
+                processor->processBlock(buffer, midi);
+                elapsed += juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - ticks);
+            }
+        }
+
+        for (auto& processor : processors)
+        {
+            processor->releaseResources();
+        }
+        return elapsed / numBlocks;
+    };
+
+    for (auto isa : { VectorKernels::Isa::scalar, VectorKernels::Isa::sse2,
+                      VectorKernels::Isa::avx2, VectorKernels::Isa::avx512 })
+    {
+        bool wanted = isa == VectorKernels::Isa::scalar || !onlyKernels.has_value() || isa == *onlyKernels;
+        if (!wanted || !VectorKernels::isSupported(isa))
+        {
+            continue;
+        }
+
+        double separateTime = renderLanes(isa, numLanes, 2);
+        double lanesTime = renderLanes(isa, 1, 2 * numLanes);
+        std::cout << "lanes   " << juce::String(VectorKernels::getName(isa)).paddedRight(' ', 7)
+                  << juce::String(separateTime * 1e6, 2) << " us per block for " << numLanes << " instances, "
+                  << juce::String(lanesTime * 1e6, 2) << " us as " << numLanes << " lanes, "
+                  << juce::String(separateTime / std::max(lanesTime, 1e-12), 2) << "x" << std::endl;
+    }
+}
+
+void Benchmark::measureReverb(const juce::AudioBuffer<float>& input)
+{
+    constexpr double impulseSeconds = 4.0;
+    int numBlocks = input.getNumSamples() / blockSize;
+    if (numBlocks < 1)
+    {
+        return;
+    }
+
+    auto renderReverb = [&](bool useWorker)
+    {
+        DelayAudioProcessor processor;
+        processor.setDecimatedWet(decimatedWet);
+        processor.setReverbLength(impulseSeconds);
+        processor.setReverbWorker(useWorker);
+        setParameter(processor, reverbParamID, 1.0f);
+        processor.setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(2, blockSize);
+        juce::MidiBuffer midi;
+        double elapsed = 0.0;
+        double slowest = 0.0;
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            buffer.copyFrom(0, 0, input, 0, block * blockSize, blockSize);
+            buffer.copyFrom(1, 0, input, 1, block * blockSize, blockSize);
+
+            auto ticks = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            double blockTime = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - ticks);
+            elapsed += blockTime;
+            slowest = std::max(slowest, blockTime);
+        }
+
+        processor.releaseResources();
+        return std::pair(elapsed / numBlocks, slowest);
+    };
+
+    for (bool useWorker : { false, true })
+    {
+        auto [average, slowest] = renderReverb(useWorker);
+        std::cout << "reverb  " << juce::String(impulseSeconds, 1) << " s impulse "
+                  << (useWorker ? "with worker    " : "without worker ")
+                  << juce::String(average * 1e6, 2) << " us per block, slowest "
+                  << juce::String(slowest * 1e6, 2) << " us" << std::endl;
+    }
+}
+
+void Benchmark::measurePool(const juce::AudioBuffer<float>& input)
+{
+    constexpr int numInstances = 16;
+    if (input.getNumSamples() < blockSize)
+    {
+        return;
+    }
+
+    // Holding the pool here keeps it alive after the instances, so what it
+    // caches for the next one shows up as well.
+    juce::SharedResourcePointer<MemoryPool> pool;
+    auto printStats = [](const char* label, const MemoryPool::Stats& stats)
+    {
+        constexpr double megabyte = 1024.0 * 1024.0;
+        std::cout << "pool    " << label << stats.numSlabs << " slabs, "
+                  << juce::String(double(stats.bytesInUse) / megabyte, 1) << " MB in use, "
+                  << juce::String(double(stats.bytesCached) / megabyte, 1) << " MB cached, "
+                  << juce::String(double(stats.bytesHugePagesRequested) / megabyte, 1) << " MB asking for huge pages, "
+                  << juce::String(double(stats.bytesHugePagesBacked) / megabyte, 1) << " MB on them, "
+                  << stats.numMapped << " mapped, " << stats.numReused << " reused, "
+                  << stats.numUnmapped << " unmapped, "
+                  << juce::String(stats.secondsPrefaulting * 1e3, 1) << " ms prefaulting" << std::endl;
+    };
+
+    std::vector<std::unique_ptr<DelayAudioProcessor>> processors;
+    auto prepareTicks = juce::Time::getHighResolutionTicks();
+    for (int instance = 0; instance < numInstances; ++instance)
+    {
+        auto& processor = processors.emplace_back(std::make_unique<DelayAudioProcessor>());
+        processor->setCompactStorage(compactStorage);
+        processor->setDecimatedWet(decimatedWet);
+        applyPreset(*processor, presets[1]);
+        processor->setPlayConfigDetails(2, 2, sampleRate, blockSize);
+        processor->prepareToPlay(sampleRate, blockSize);
+    }
+    double prepareTime = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - prepareTicks);
+
+    juce::AudioBuffer<float> buffer(2, blockSize);
+    juce::MidiBuffer midi;
+    double elapsed = 0.0;
+    double slowest = 0.0;
+    for (auto& processor : processors)
+    {
+        buffer.copyFrom(0, 0, input, 0, 0, blockSize);
+        buffer.copyFrom(1, 0, input, 1, 0, blockSize);
+
+        auto ticks = juce::Time::getHighResolutionTicks();
+        processor->processBlock(buffer, midi);
+        double blockTime = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - ticks);
+        elapsed += blockTime;
+        slowest = std::max(slowest, blockTime);
+    }
+
+    std::cout << "pool    " << numInstances << " instances prepared in "
+              << juce::String(prepareTime * 1e3, 1) << " ms, first block "
+              << juce::String(elapsed / numInstances * 1e6, 2) << " us on average, slowest "
+              << juce::String(slowest * 1e6, 2) << " us" << std::endl;
+    printStats("playing   ", pool->getStats());
+
+    processors.clear();
+    printStats("destroyed ", pool->getStats());
+}
+
+void Benchmark::run(double seconds)
+{
+    int numSamples = int(seconds * sampleRate);
+    juce::AudioBuffer<float> input(2, numSamples);
+    juce::AudioBuffer<float> reference;
+    juce::AudioBuffer<float> output;
+
+    // The scalar path always runs first, it is the reference for the others.
+    juce::Array<VectorKernels::Isa> paths;
+    for (auto isa : { VectorKernels::Isa::scalar, VectorKernels::Isa::sse2,
+                      VectorKernels::Isa::avx2, VectorKernels::Isa::avx512 })
+    {
+        bool wanted = isa == VectorKernels::Isa::scalar || !onlyKernels.has_value() || isa == *onlyKernels;
+        if (wanted && VectorKernels::isSupported(isa))
+        {
+            paths.add(isa);
+        }
+    }
+
+    std::cout << "sample rate " << sampleRate << " Hz, block size " << blockSize
+              << ", " << seconds << " s per render, automatic kernels "
+              << VectorKernels::getName(VectorKernels::select({}))
+              << (compactStorage ? ", compact storage" : "")
+              << (decimatedWet ? ", decimated wet path" : "") << std::endl;
+
+    measureEditorOpen();
+
+    for (auto signal : { Signal::impulse, Signal::sweep, Signal::noise })
+    {
+        fillSignal(input, signal, sampleRate);
+
+        for (const auto& preset : presets)
+        {
+            for (auto isa : paths)
+            {
+                bool isReference = isa == VectorKernels::Isa::scalar;
+                auto result = render(preset, isa, input, isReference ? reference : output);
+                double realtime = seconds / std::max(result.secondsElapsed, 1e-9);
+                double nsPerSample = result.secondsElapsed * 1e9 / numSamples;
+
+                // Vector paths may fuse multiply-adds, so tiny differences are expected.
+                float difference = 0.0f;
+                if (!isReference)
+                {
+                    for (int channel = 0; channel < 2; ++channel)
+                    {
+                        for (int i = 0; i < numSamples; ++i)
+                        {
+                            difference = std::max(difference, std::abs(output.getSample(channel, i) - reference.getSample(channel, i)));
+                        }
+                    }
+                }
+
+                std::cout << juce::String(getSignalName(signal)).paddedRight(' ', 9)
+                          << juce::String(preset.name).paddedRight(' ', 15)
+                          << juce::String(VectorKernels::getName(isa)).paddedRight(' ', 7)
+                          << juce::String(realtime, 1).paddedLeft(' ', 9) << "x realtime"
+                          << juce::String(nsPerSample, 2).paddedLeft(' ', 9) << " ns/sample"
+                          << "   peak " << juce::String(juce::Decibels::gainToDecibels(result.peak), 1) << " dB"
+                          << (isReference ? juce::String() : "   diff " + juce::String(juce::Decibels::gainToDecibels(difference, -200.0f), 1) + " dB")
+                          << (result.finite ? "" : "   NON-FINITE OUTPUT") << std::endl;
+            }
+        }
+    }
+
+    // The input holds noise now, which keeps every stage busy.
+    measureTraceOverhead(input);
+    measureCaptureCost(input);
+    measurePipeline(input);
+    measureLanes(input);
+    measureReverb(input);
+    measurePool(input);
+}
@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    Benchmark.h
+    Created: 19 Oct 2026 9:12:05am
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/VectorKernels.h"
+#include <array>
+
+class DelayAudioProcessor;
+
+class Benchmark
+{
+public:
+    Benchmark(double sampleRate, int blockSize);
+
+    // Renders every reference signal through every preset with each kernel
+    // path and prints the throughput as a multiple of realtime. Every path is
+    // also compared against the scalar reference.
+    void run(double seconds);
+
+    // Limits the run to one kernel path besides the scalar reference.
+    void setKernels(std::optional<VectorKernels::Isa> isa)
+    {
+        onlyKernels = isa;
+    }
+
+    // Runs with half-float delay buffers.
+    void setCompactStorage(bool shouldBeCompact)
+    {
+        compactStorage = shouldBeCompact;
+    }
+
+    // Runs the engines at a reduced rate when the sample rate allows it.
+    void setDecimatedWet(bool shouldBeDecimated)
+    {
+        decimatedWet = shouldBeDecimated;
+    }
+
+    enum class Signal
+    {
+        impulse,
+        sweep,
+        noise,
+    };
+
+    struct Preset
+    {
+        const char* name;
+        bool reverse;
+        bool tempoSync;
+        float delayTime;
+        float feedback;
+    };
+
+    // Forward, reverse, tempo-synced and high-feedback settings.
+    static const std::array<Preset, 4> presets;
+
+    static const char* getSignalName(Signal signal);
+    static void fillSignal(juce::AudioBuffer<float>& buffer, Signal signal, double sampleRate);
+    static void applyPreset(DelayAudioProcessor& processor, const Preset& preset);
+
+    // Sets a parameter in its own units, as the host would.
+    static void setParameter(DelayAudioProcessor& processor, const juce::ParameterID& id, float value);
+
+private:
+    struct Result
+    {
+        double secondsElapsed = 0.0;
+        float peak = 0.0f;
+        bool finite = true;
+    };
+
+    Result render(const Preset& preset, VectorKernels::Isa isa,
+                  const juce::AudioBuffer<float>& input, juce::AudioBuffer<float>& output);
+
+    // Times opening the editor, first paint included: cold, while another
+    // editor keeps the shared UI resources alive, and cold again after the
+    // last editor has closed and released them.
+    void measureEditorOpen();
+
+    // Renders the forward and reverse presets with and without a trace
+    // capture running. Builds without DELAY_TRACING skip this.
+    void measureTraceOverhead(const juce::AudioBuffer<float>& input);
+
+    // Compares the block time while a capture of the full delay history is
+    // being copied out against the blocks before it.
+    void measureCaptureCost(const juce::AudioBuffer<float>& input);
+
+    // Renders the heavy preset with and without the pipeline while the host
+    // thread has as much other work per block as the engines, and checks
+    // that the pipelined output is the same one block later.
+    void measurePipeline(const juce::AudioBuffer<float>& input);
+
+    // Renders the forward preset through 16 stereo instances one after the
+    // other and through one instance with a 32-channel bus, which runs the
+    // same delays as lanes side by side, for each kernel path.
+    void measureLanes(const juce::AudioBuffer<float>& input);
+
+    // Renders the reverse reverb with a long generated impulse, with the
+    // largest partitions on the worker and without it, and reports the
+    // average and the slowest block.
+    void measureReverb(const juce::AudioBuffer<float>& input);
+
+    // Prepares a session's worth of instances, times their first block,
+    // which is where page faults used to land, and reports what the shared
+    // memory pool holds with the instances and after they are gone.
+    void measurePool(const juce::AudioBuffer<float>& input);
+
+    double sampleRate;
+    int blockSize;
+    std::optional<VectorKernels::Isa> onlyKernels;
+    bool compactStorage = false;
+    bool decimatedWet = false;
+};
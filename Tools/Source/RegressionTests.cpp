@@ -0,0 +1,768 @@
+/*
+  ==============================================================================
+
+    RegressionTests.cpp
+    Created: 19 Oct 2026 9:47:31am
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#include "RegressionTests.h"
+#include "BatchRenderer.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/SpectralReverse.h"
+
+// Reports a fixed tempo, so the synced settings do not fall back to the
+// processor's default.
+class FixedTempoPlayHead : public juce::AudioPlayHead
+{
+public:
+    explicit FixedTempoPlayHead(double bpm_) : bpm(bpm_) {}
+
+    void setPosition(juce::int64 samplePosition) noexcept
+    {
+        position = samplePosition;
+    }
+
+    juce::Optional<PositionInfo> getPosition() const override
+    {
+        PositionInfo info;
+        info.setBpm(bpm);
+        info.setIsPlaying(true);
+        info.setTimeInSamples(position);
+        return info;
+    }
+
+private:
+    double bpm;
+    juce::int64 position = 0;
+};
+
+static constexpr std::array<Benchmark::Signal, 3> signals =
+{
+    Benchmark::Signal::impulse,
+    Benchmark::Signal::sweep,
+    Benchmark::Signal::noise,
+};
+
+static float getEnergy(const juce::AudioBuffer<float>& buffer, int start, int numSamples)
+{
+    float energy = 0.0f;
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+    {
+        const float* data = buffer.getReadPointer(channel, start);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            energy += data[i] * data[i];
+        }
+    }
+    return energy;
+}
+
+RegressionTests::RegressionTests(const juce::File& goldenFolder_, bool updateGolden_)
+    : goldenFolder(goldenFolder_), updateGolden(updateGolden_)
+{
+}
+
+int RegressionTests::run()
+{
+    checkGolden();
+    checkKernelPaths();
+    checkFeedbackBounded();
+    checkReverseSegments();
+    checkTempoSync();
+    checkHalfFloats();
+    checkPipeline();
+    checkBatchThreads();
+    checkSpectralReset();
+    checkSwellAlignment();
+    checkLaneSettings();
+    checkHistoryGrowth();
+    checkLegacyState();
+
+    std::cout << numFailed << " of " << numChecks << " checks failed" << std::endl;
+    return numFailed;
+}
+
+void RegressionTests::expect(bool condition, const juce::String& name, const juce::String& detail)
+{
+    ++numChecks;
+    if (!condition)
+    {
+        ++numFailed;
+    }
+    std::cout << (condition ? "pass  " : "FAIL  ") << name.paddedRight(' ', 34) << detail << std::endl;
+}
+
+void RegressionTests::render(DelayAudioProcessor& processor, const juce::AudioBuffer<float>& input,
+                             juce::AudioBuffer<float>& output, int renderBlockSize, double bpm,
+                             const std::function<void(int)>& afterBlock)
+{
+    FixedTempoPlayHead playHead(bpm);
+    processor.setPlayHead(&playHead);
+    processor.setPlayConfigDetails(2, 2, sampleRate, renderBlockSize);
+    processor.prepareToPlay(sampleRate, renderBlockSize);
+
+    int numSamples = input.getNumSamples();
+    output.setSize(2, numSamples, false, false, true);
+    juce::MidiBuffer midi;
+
+    for (int start = 0; start < numSamples; start += renderBlockSize)
+    {
+        int blockLength = std::min(renderBlockSize, numSamples - start);
+        output.copyFrom(0, start, input, 0, start, blockLength);
+        output.copyFrom(1, start, input, 1, start, blockLength);
+
+        juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), 2, start, blockLength);
+        playHead.setPosition(start);
+        processor.processBlock(block, midi);
+
+        if (afterBlock)
+        {
+            afterBlock(start + blockLength);
+        }
+    }
+
+    processor.releaseResources();
+    processor.setPlayHead(nullptr);
+}
+
+juce::String RegressionTests::getGoldenName(const Benchmark::Preset& preset, Benchmark::Signal signal)
+{
+    return juce::String(preset.name).replaceCharacter(' ', '-') + "-" + Benchmark::getSignalName(signal) + ".wav";
+}
+
+float RegressionTests::getMaxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b,
+                                        int offset)
+{
+    if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+
+    // a[i] is compared with b[i - offset].
+    float largest = 0.0f;
+    for (int channel = 0; channel < a.getNumChannels(); ++channel)
+    {
+        for (int i = offset; i < a.getNumSamples(); ++i)
+        {
+            float difference = std::abs(a.getSample(channel, i) - b.getSample(channel, i - offset));
+            if (!std::isfinite(difference))
+            {
+                return std::numeric_limits<float>::infinity();
+            }
+            largest = std::max(largest, difference);
+        }
+    }
+    return largest;
+}
+
+void RegressionTests::checkGolden()
+{
+    if (updateGolden && !goldenFolder.createDirectory())
+    {
+        expect(false, "golden folder", "cannot create " + goldenFolder.getFullPathName());
+        return;
+    }
+
+    juce::WavAudioFormat wav;
+    juce::AudioBuffer<float> input(2, int(goldenSeconds * sampleRate));
+    juce::AudioBuffer<float> output, reference;
+
+    for (const auto& preset : Benchmark::presets)
+    {
+        for (auto signal : signals)
+        {
+            Benchmark::fillSignal(input, signal, sampleRate);
+
+            DelayAudioProcessor processor;
+            processor.forceKernels(VectorKernels::Isa::scalar);
+            Benchmark::applyPreset(processor, preset);
+            render(processor, input, output, blockSize);
+
+            auto name = getGoldenName(preset, signal);
+            auto file = goldenFolder.getChildFile(name);
+
+            if (updateGolden)
+            {
+                file.deleteFile();
+                auto stream = std::make_unique<juce::FileOutputStream>(file);
+                std::unique_ptr<juce::AudioFormatWriter> writer;
+                if (!stream->failedToOpen())
+                {
+                    writer.reset(wav.createWriterFor(stream.get(), sampleRate, 2, 32, {}, 0));
+                }
+                if (writer != nullptr)
+                {
+                    stream.release();
+                }
+
+                bool written = writer != nullptr && writer->writeFromAudioSampleBuffer(output, 0, output.getNumSamples());
+                expect(written, "golden " + name, written ? "written" : "cannot write " + file.getFullPathName());
+                continue;
+            }
+
+            std::unique_ptr<juce::AudioFormatReader> reader;
+            if (file.existsAsFile())
+            {
+                reader.reset(wav.createReaderFor(file.createInputStream().release(), true));
+            }
+            if (reader == nullptr)
+            {
+                expect(false, "golden " + name, "no reference in " + goldenFolder.getFullPathName()
+                                                + ", see --update-golden");
+                continue;
+            }
+
+            reference.setSize(int(reader->numChannels), int(reader->lengthInSamples));
+            reader->read(&reference, 0, reference.getNumSamples(), 0, true, true);
+
+            float difference = getMaxDifference(output, reference);
+            expect(difference <= goldenTolerance, "golden " + name,
+                   "largest difference " + juce::String(difference, 8));
+        }
+    }
+}
+
+void RegressionTests::checkKernelPaths()
+{
+    juce::AudioBuffer<float> input(2, int(goldenSeconds * sampleRate));
+    juce::AudioBuffer<float> reference, output;
+    Benchmark::fillSignal(input, Benchmark::Signal::noise, sampleRate);
+
+    for (const auto& preset : Benchmark::presets)
+    {
+        DelayAudioProcessor scalarProcessor;
+        scalarProcessor.forceKernels(VectorKernels::Isa::scalar);
+        Benchmark::applyPreset(scalarProcessor, preset);
+        render(scalarProcessor, input, reference, blockSize);
+
+        // The feedback keeps the noise building up, so the tolerance
+        // follows the level once it passes full scale.
+        float peak = std::max(reference.getMagnitude(0, 0, reference.getNumSamples()),
+                              reference.getMagnitude(1, 0, reference.getNumSamples()));
+        float tolerance = kernelTolerance * std::max(1.0f, peak);
+
+        for (auto isa : { VectorKernels::Isa::sse2, VectorKernels::Isa::avx2, VectorKernels::Isa::avx512 })
+        {
+            if (!VectorKernels::isSupported(isa))
+            {
+                continue;
+            }
+
+            DelayAudioProcessor processor;
+            processor.forceKernels(isa);
+            Benchmark::applyPreset(processor, preset);
+            render(processor, input, output, blockSize);
+
+            float difference = getMaxDifference(output, reference);
+            expect(difference <= tolerance,
+                   juce::String("kernels ") + VectorKernels::getName(isa) + " " + preset.name,
+                   "largest difference from scalar " + juce::String(difference, 8));
+        }
+    }
+}
+
+void RegressionTests::checkFeedbackBounded()
+{
+    constexpr double seconds = 20.0;
+    juce::AudioBuffer<float> burst(2, int(0.1 * sampleRate));
+    juce::AudioBuffer<float> input(2, int(seconds * sampleRate));
+    juce::AudioBuffer<float> output;
+
+    Benchmark::fillSignal(burst, Benchmark::Signal::noise, sampleRate);
+    input.clear();
+    input.copyFrom(0, 0, burst, 0, 0, burst.getNumSamples());
+    input.copyFrom(1, 0, burst, 1, 0, burst.getNumSamples());
+    float burstPeak = burst.getMagnitude(0, burst.getNumSamples());
+
+    // The loop may keep its energy but must not build up, so the last seconds
+    // hold no more than the first repeats, give or take rounding.
+    // The filters can still line peaks up a little higher than the burst.
+    const Benchmark::Preset forward { "forward", false, false, 250.0f, 100.0f };
+    for (const auto& preset : { forward, Benchmark::presets[3] })
+    {
+        DelayAudioProcessor processor;
+        Benchmark::applyPreset(processor, preset);
+        render(processor, input, output, blockSize);
+
+        bool finite = true;
+        float peak = 0.0f;
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax(output.getReadPointer(channel), output.getNumSamples());
+            finite = finite && std::isfinite(range.getStart()) && std::isfinite(range.getEnd());
+            peak = std::max({ peak, std::abs(range.getStart()), std::abs(range.getEnd()) });
+        }
+
+        int window = int(4.0 * sampleRate);
+        float early = getEnergy(output, int(1.0 * sampleRate), window);
+        float late = getEnergy(output, output.getNumSamples() - window, window);
+
+        expect(finite && peak <= 4.0f * burstPeak && late <= early * 1.001f,
+               juce::String("100% feedback ") + preset.name,
+               "peak " + juce::String(peak / burstPeak, 2) + "x the burst, energy of the last 4 s "
+               + juce::String(late / std::max(early, 1e-12f), 3) + "x the first");
+    }
+}
+
+std::pair<double, int> RegressionTests::measureSegments(DelayAudioProcessor& processor, double seconds, double bpm)
+{
+    juce::AudioBuffer<float> input(2, int(seconds * sampleRate)), output;
+    Benchmark::fillSignal(input, Benchmark::Signal::noise, sampleRate);
+
+    float lastPhase = 0.0f;
+    int firstBoundary = -1, lastBoundary = -1, numBoundaries = 0;
+    render(processor, input, output, 1, bpm, [&](int position)
+    {
+        if (processor.reversePhase < lastPhase)
+        {
+            firstBoundary = firstBoundary < 0 ? position : firstBoundary;
+            lastBoundary = position;
+            ++numBoundaries;
+        }
+        lastPhase = processor.reversePhase;
+    });
+
+    if (numBoundaries < 2)
+    {
+        return { 0.0, numBoundaries };
+    }
+    return { double(lastBoundary - firstBoundary) / double(numBoundaries - 1), numBoundaries };
+}
+
+void RegressionTests::checkReverseSegments()
+{
+    // The fractional times are no whole number of samples, so a length
+    // rounded anywhere would drift by a fraction of a sample per segment.
+    for (float delayTime : { 250.0f, 123.45f, 1000.0f })
+    {
+        DelayAudioProcessor processor;
+        Benchmark::applyPreset(processor, { "reverse", true, false, delayTime, 0.0f });
+
+        float parameterTime = processor.apvts.getRawParameterValue(delayTimeParamID.getParamID())->load();
+        double expected = double(parameterTime) / 1000.0 * sampleRate;
+        auto [length, numSegments] = measureSegments(processor, 10.0, 120.0);
+
+        // Whole samples between boundaries limit the average to this.
+        double tolerance = 1.0 / std::max(1, numSegments - 1);
+        expect(std::abs(length - expected) <= tolerance,
+               "reverse segment " + juce::String(parameterTime, 2) + " ms",
+               juce::String(length, 3) + " samples on average over " + juce::String(numSegments)
+               + " segments, expected " + juce::String(expected, 3));
+    }
+}
+
+void RegressionTests::checkTempoSync()
+{
+    // Anything but the 120 bpm the processor falls back to.
+    constexpr double bpm = 97.0;
+    FixedTempoPlayHead playHead(bpm);
+    Tempo tempo;
+    tempo.update(playHead.getPosition());
+
+    // With the mix all the way up and no feedback, only the first echo of
+    // the impulse comes out. Interpolation splits it over two samples when
+    // the delay is no whole number of them.
+    for (int note : { 3, 7, 9, 14 })
+    {
+        double expected = tempo.getMillisecondsForNoteLength(note) / 1000.0 * sampleRate;
+        juce::AudioBuffer<float> input(2, int(expected) + 4096), output;
+        input.clear();
+        input.setSample(0, 0, 1.0f);
+        input.setSample(1, 0, 1.0f);
+
+        DelayAudioProcessor processor;
+        Benchmark::applyPreset(processor, Benchmark::presets[2]);
+        Benchmark::setParameter(processor, delayNoteParamID, float(note));
+        Benchmark::setParameter(processor, feedbackParamID, 0.0f);
+        Benchmark::setParameter(processor, mixParamID, 100.0f);
+        render(processor, input, output, blockSize, bpm);
+
+        int echo = 0;
+        for (int i = 1; i < output.getNumSamples(); ++i)
+        {
+            if (std::abs(output.getSample(0, i)) > std::abs(output.getSample(0, echo)))
+            {
+                echo = i;
+            }
+        }
+        expect(std::abs(double(echo) - expected) <= 1.0, "tempo sync note " + juce::String(note),
+               "echo at " + juce::String(echo) + ", expected " + juce::String(expected, 2));
+    }
+
+    DelayAudioProcessor processor;
+    Benchmark::applyPreset(processor, { "reverse sync", true, true, 250.0f, 0.0f });
+    Benchmark::setParameter(processor, delayNoteParamID, 6.0f);
+    double expected = tempo.getMillisecondsForNoteLength(6) / 1000.0 * sampleRate;
+    auto [length, numSegments] = measureSegments(processor, 10.0, bpm);
+    expect(std::abs(length - expected) <= 1.0 / std::max(1, numSegments - 1), "tempo sync reverse segment",
+           juce::String(length, 3) + " samples on average, expected " + juce::String(expected, 3));
+}
+
+void RegressionTests::checkHalfFloats()
+{
+    // Every finite half once, and random bit patterns that cover float
+    // subnormals, infinities and values far outside the half range.
+    std::vector<juce::uint16> halves;
+    std::vector<float> decoded;
+    for (juce::uint32 bits = 0; bits < 0x10000u; ++bits)
+    {
+        if ((bits & 0x7c00u) != 0x7c00u)
+        {
+            halves.push_back(juce::uint16(bits));
+            decoded.push_back(HalfFloat::toFloat(juce::uint16(bits)));
+        }
+    }
+
+    juce::Random random(42);
+    std::vector<float> floats(size_t(1) << 22);
+    for (auto& value : floats)
+    {
+        do
+        {
+            value = std::bit_cast<float>(random.nextInt());
+        }
+        while (std::isnan(value));
+    }
+
+    int numHalves = int(halves.size());
+    int numFloats = int(floats.size());
+    const auto& scalar = VectorKernels::get(VectorKernels::Isa::scalar);
+
+    for (bool noDenormals : { false, true })
+    {
+        std::optional<juce::ScopedNoDenormals> scopedNoDenormals;
+        if (noDenormals)
+        {
+            scopedNoDenormals.emplace();
+        }
+
+        std::vector<float> scalarDecoded(halves.size());
+        std::vector<juce::uint16> scalarEncoded(floats.size());
+        scalar.interpolateHalf(scalarDecoded.data(), halves.data(), halves.data(), 0.0f, numHalves);
+        scalar.encodeHalf(scalarEncoded.data(), floats.data(), numFloats);
+
+        for (auto isa : { VectorKernels::Isa::scalar, VectorKernels::Isa::sse2,
+                          VectorKernels::Isa::avx2, VectorKernels::Isa::avx512 })
+        {
+            if (!VectorKernels::isSupported(isa))
+            {
+                continue;
+            }
+
+            const auto& kernels = VectorKernels::get(isa);
+            std::vector<float> pathDecoded(halves.size());
+            std::vector<juce::uint16> roundTrip(halves.size());
+            std::vector<juce::uint16> pathEncoded(floats.size());
+            kernels.interpolateHalf(pathDecoded.data(), halves.data(), halves.data(), 0.0f, numHalves);
+            kernels.encodeHalf(roundTrip.data(), decoded.data(), numHalves);
+            kernels.encodeHalf(pathEncoded.data(), floats.data(), numFloats);
+
+            bool sameDecoded = std::memcmp(pathDecoded.data(), scalarDecoded.data(), halves.size() * sizeof(float)) == 0;
+            bool sameRoundTrip = roundTrip == halves;
+            bool sameEncoded = pathEncoded == scalarEncoded;
+
+            expect(sameDecoded && sameRoundTrip && sameEncoded,
+                   juce::String("half floats ") + VectorKernels::getName(isa) + (noDenormals ? " ftz/daz" : ""),
+                   juce::String(numHalves) + " halves decode " + (sameDecoded ? "identically" : "DIFFERENTLY")
+                   + " and round-trip " + (sameRoundTrip ? "exactly" : "INEXACTLY") + ", "
+                   + juce::String(numFloats) + " floats encode " + (sameEncoded ? "identically" : "DIFFERENTLY"));
+        }
+    }
+}
+
+void RegressionTests::checkPipeline()
+{
+    int numSamples = int(goldenSeconds * sampleRate) / blockSize * blockSize;
+    juce::AudioBuffer<float> input(2, numSamples), serial, pipelined;
+    Benchmark::fillSignal(input, Benchmark::Signal::noise, sampleRate);
+
+    for (bool isPipelined : { false, true })
+    {
+        DelayAudioProcessor processor;
+        processor.setPipelined(isPipelined);
+        Benchmark::applyPreset(processor, Benchmark::presets[3]);
+        render(processor, input, isPipelined ? pipelined : serial, blockSize);
+    }
+
+    float difference = getMaxDifference(pipelined, serial, blockSize);
+    expect(difference == 0.0f, "pipeline",
+           difference == 0.0f ? "bit-identical one block later"
+                              : "largest difference " + juce::String(difference, 8));
+}
+
+void RegressionTests::checkBatchThreads()
+{
+    auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory)
+                      .getNonexistentChildFile("DelayToolTest", "", false);
+    auto inputFolder = folder.getChildFile("input");
+    inputFolder.createDirectory();
+
+    // More files than one worker, so it renders each after another one.
+    juce::WavAudioFormat wav;
+    juce::Array<juce::File> files;
+    juce::AudioBuffer<float> buffer(2, int(2.0 * sampleRate));
+    for (auto signal : signals)
+    {
+        Benchmark::fillSignal(buffer, signal, sampleRate);
+        auto file = inputFolder.getChildFile(juce::String(Benchmark::getSignalName(signal)) + ".wav");
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, 2, 32, {}, 0));
+        if (writer != nullptr)
+        {
+            stream.release();
+            writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+        }
+        files.add(file);
+    }
+
+    // Reverse with the spectral engine and blur, which keep the most state
+    // from one file to the next.
+    BatchRenderer::Options options;
+    {
+        DelayAudioProcessor processor;
+        Benchmark::applyPreset(processor, Benchmark::presets[1]);
+        Benchmark::setParameter(processor, spectralParamID, 1.0f);
+        Benchmark::setParameter(processor, blurParamID, 50.0f);
+        processor.getStateInformation(options.state);
+    }
+    options.blockSize = blockSize;
+    options.tailSeconds = 1.0;
+
+    int numFailedRenders = 0;
+    for (int numThreads : { 1, 3 })
+    {
+        options.numThreads = numThreads;
+        options.outputFolder = folder.getChildFile(juce::String(numThreads));
+        numFailedRenders += BatchRenderer(options).render(files);
+    }
+
+    bool identical = numFailedRenders == 0;
+    for (const auto& file : files)
+    {
+        auto single = folder.getChildFile("1").getChildFile(file.getFileName());
+        auto several = folder.getChildFile("3").getChildFile(file.getFileName());
+        identical = identical && single.existsAsFile() && single.hasIdenticalContentTo(several);
+    }
+    folder.deleteRecursively();
+
+    expect(identical, "batch render threads",
+           identical ? "1 and 3 workers write identical files"
+                     : juce::String(numFailedRenders) + " failed renders or files that differ");
+}
+
+void RegressionTests::checkSpectralReset()
+{
+    SpectralReverse spectral;
+    spectral.prepare(int(sampleRate), SpectralReverse::Options());
+    spectral.reserve(int(0.5 * sampleRate));
+    spectral.setSegmentLength(int(0.5 * sampleRate));
+    spectral.setBlur(1.0f);
+
+    juce::AudioBuffer<float> noise(2, int(2.0 * sampleRate));
+    Benchmark::fillSignal(noise, Benchmark::Signal::noise, sampleRate);
+
+    float outputL = 0.0f, outputR = 0.0f;
+    for (int i = 0; i < noise.getNumSamples(); ++i)
+    {
+        spectral.processSample(noise.getSample(0, i), noise.getSample(1, i), outputL, outputR);
+    }
+
+    spectral.reset();
+    float peak = 0.0f;
+    for (int i = 0; i < noise.getNumSamples(); ++i)
+    {
+        spectral.processSample(0.0f, 0.0f, outputL, outputR);
+        peak = std::max({ peak, std::abs(outputL), std::abs(outputR) });
+    }
+
+    expect(peak == 0.0f, "spectral reset with full blur", "peak " + juce::String(peak, 8) + " after the reset");
+}
+
+void RegressionTests::checkSwellAlignment()
+{
+    // Clicks with a noise tail on silence. The later ones are closer
+    // together than the segment, so their segments are cut short.
+    const std::array<double, 5> clickTimes { 0.3, 1.0, 1.2, 1.35, 2.5 };
+    juce::AudioBuffer<float> input(2, int(4.0 * sampleRate)), output;
+    input.clear();
+    juce::Random random(1);
+    for (double time : clickTimes)
+    {
+        int click = int(time * sampleRate);
+        for (int i = 0; i < int(0.1 * sampleRate); ++i)
+        {
+            float tail = i == 0 ? 1.0f : 0.3f * std::exp(-float(i) / 1000.0f) * (random.nextFloat() * 2.0f - 1.0f);
+            input.setSample(0, click + i, tail);
+            input.setSample(1, click + i, tail);
+        }
+    }
+
+    DelayAudioProcessor processor;
+    Benchmark::applyPreset(processor, { "reverse", true, false, 500.0f, 0.0f });
+    Benchmark::setParameter(processor, lookaheadParamID, 1.0f);
+    Benchmark::setParameter(processor, reverseTriggerParamID, 1.0f);
+    Benchmark::setParameter(processor, mixParamID, 100.0f);
+    render(processor, input, output, blockSize);
+    int latency = processor.getLatencySamples();
+
+    // The loudest sample near where each click should come out.
+    int window = int(0.05 * sampleRate);
+    int worst = 0;
+    for (double time : clickTimes)
+    {
+        int expected = int(time * sampleRate) + latency;
+        int peak = expected - window;
+        for (int i = expected - window; i <= expected + window; ++i)
+        {
+            if (std::abs(output.getSample(0, i)) > std::abs(output.getSample(0, peak)))
+            {
+                peak = i;
+            }
+        }
+        worst = std::max(worst, std::abs(peak - expected));
+    }
+
+    expect(worst <= 2, "swells on their onsets",
+           "worst peak " + juce::String(worst) + " samples from its click at latency " + juce::String(latency));
+}
+
+void RegressionTests::checkLaneSettings()
+{
+    constexpr int numChannels = 4;
+    DelayAudioProcessor saved;
+    saved.setLaneSettings(1, { 2.0f, 0.5f, 0.0f });
+    juce::MemoryBlock data;
+    saved.getStateInformation(data);
+
+    DelayAudioProcessor processor;
+    processor.setStateInformation(data.getData(), int(data.getSize()));
+    Benchmark::applyPreset(processor, Benchmark::presets[0]);
+    Benchmark::setParameter(processor, feedbackParamID, 0.0f);
+    Benchmark::setParameter(processor, mixParamID, 100.0f);
+    processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    // An impulse on every channel, and the loudest sample of each lane.
+    float delayTime = processor.apvts.getRawParameterValue(delayTimeParamID.getParamID())->load();
+    double expected = double(delayTime) / 1000.0 * sampleRate;
+    int numSamples = int(3.0 * expected);
+    std::array<int, numChannels / 2> echoes {};
+    std::array<float, numChannels / 2> peaks {};
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    for (int start = 0; start < numSamples; start += blockSize)
+    {
+        buffer.clear();
+        if (start == 0)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                buffer.setSample(channel, 0, 1.0f);
+            }
+        }
+        processor.processBlock(buffer, midi);
+        for (int lane = 0; lane < numChannels / 2; ++lane)
+        {
+            for (int i = 0; i < blockSize; ++i)
+            {
+                float value = std::abs(buffer.getSample(2 * lane, i));
+                if (value > peaks[size_t(lane)])
+                {
+                    peaks[size_t(lane)] = value;
+                    echoes[size_t(lane)] = start + i;
+                }
+            }
+        }
+    }
+    processor.releaseResources();
+
+    auto settings = processor.getLaneSettings(1);
+    expect(std::abs(echoes[0] - expected) <= 1.0 && std::abs(echoes[1] - 2.0 * expected) <= 1.0
+           && settings.timeScale == 2.0f && settings.feedbackScale == 0.5f, "lane settings",
+           "echoes at " + juce::String(echoes[0]) + " and " + juce::String(echoes[1]) + ", expected "
+           + juce::String(expected, 2) + " and " + juce::String(2.0 * expected, 2));
+}
+
+void RegressionTests::checkHistoryGrowth()
+{
+    juce::AudioBuffer<float> noise(2, int(6.0 * sampleRate));
+    Benchmark::fillSignal(noise, Benchmark::Signal::noise, sampleRate);
+    const auto& kernels = VectorKernels::get(VectorKernels::Isa::scalar);
+
+    for (auto storage : { DelayBuffer::Storage::full, DelayBuffer::Storage::compact })
+    {
+        for (bool offline : { false, true })
+        {
+            // One second long until three seconds in, then four.
+            DelayBuffer history;
+            history.prepare(int(sampleRate), kernels, storage);
+            int growAt = int(3.0 * sampleRate);
+            int longDelay = int(4.0 * sampleRate);
+
+            int numWritten = 0;
+            for (; numWritten + blockSize <= noise.getNumSamples(); numWritten += blockSize)
+            {
+                if (offline && numWritten == growAt / blockSize * blockSize)
+                {
+                    history.reserve(longDelay);
+                }
+                history.grow(numWritten < growAt ? int(sampleRate) : longDelay, blockSize);
+                history.write(noise.getReadPointer(0, numWritten), noise.getReadPointer(1, numWritten), blockSize);
+
+                // Gives the background thread about the time it would have
+                // between real blocks.
+                if (numWritten >= growAt && history.getMaxDelay() < longDelay)
+                {
+                    juce::Thread::sleep(5);
+                }
+            }
+
+            // From half a second before the grow, which leaves the
+            // background thread that long to deliver.
+            int numSamples = numWritten - int(2.5 * sampleRate);
+            juce::AudioBuffer<float> copy(2, numSamples);
+            float maxDifference = 0.0f;
+            if (history.getMaxDelay() >= longDelay)
+            {
+                history.copyHistory(copy.getWritePointer(0), copy.getWritePointer(1), numSamples, numSamples);
+                for (int channel = 0; channel < 2; ++channel)
+                {
+                    for (int i = 0; i < numSamples; ++i)
+                    {
+                        float expected = noise.getSample(channel, numWritten - numSamples + i);
+                        maxDifference = std::max(maxDifference, std::abs(copy.getSample(channel, i) - expected));
+                    }
+                }
+            }
+
+            // Half floats keep an 11-bit mantissa.
+            float tolerance = storage == DelayBuffer::Storage::compact ? 1.0e-3f : 0.0f;
+            juce::String name = juce::String("grown history, ") + (offline ? "offline" : "thread")
+                              + (storage == DelayBuffer::Storage::compact ? ", compact" : "");
+            expect(history.getMaxDelay() >= longDelay && maxDifference <= tolerance, name,
+                   "max delay " + juce::String(history.getMaxDelay()) + ", difference "
+                   + juce::String(maxDifference, 8));
+        }
+    }
+}
+
+void RegressionTests::checkLegacyState()
+{
+    // The state as a version with the 5 s range saved it.
+    DelayAudioProcessor saved;
+    Benchmark::setParameter(saved, delayTimeParamID, 2500.0f);
+    auto state = saved.apvts.copyState();
+    state.getChildWithProperty("id", delayTimeParamID.getParamID())
+         .setProperty("id", legacyDelayTimeParamID.getParamID(), nullptr);
+    juce::MemoryBlock data;
+    juce::AudioProcessor::copyXmlToBinary(*state.createXml(), data);
+
+    DelayAudioProcessor loaded;
+    loaded.setStateInformation(data.getData(), int(data.getSize()));
+    float delayTime = loaded.apvts.getRawParameterValue(delayTimeParamID.getParamID())->load();
+    expect(std::abs(delayTime - 2500.0f) < 0.01f, "legacy delay time",
+           juce::String(delayTime, 2) + " ms, expected 2500 ms");
+}
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+    RegressionTests.h
+    Created: 19 Oct 2026 9:47:31am
+    Author:  Taha Cheema
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Benchmark.h"
+
+class DelayAudioProcessor;
+
+// Checks the processor against reference renders and against the
+// properties the DSP promises, for DelayTool --test.
+//
+// The reference renders are the benchmark signals through the benchmark
+// presets with the scalar kernels, stored as 32-bit float WAV files in the
+// golden folder. --update-golden writes them from the current build instead
+// of comparing, for changes that are meant to alter the sound.
+class RegressionTests
+{
+public:
+    RegressionTests(const juce::File& goldenFolder, bool updateGolden);
+
+    // Runs every check, prints one line per check and returns the number
+    // that failed.
+    int run();
+
+    // The rendered sound may drift this far from the references, about
+    // -80 dBFS, which covers different compilers and maths libraries.
+    static constexpr float goldenTolerance = 1.0e-4f;
+
+    // The same for the wider kernel paths against the scalar one, which
+    // differ in FMA contraction and summation order.
+    static constexpr float kernelTolerance = 1.0e-4f;
+
+private:
+    // Prepares the processor with a play head at the given tempo, runs the
+    // input through it block by block and releases it again. afterBlock is
+    // called with the number of samples processed so far.
+    void render(DelayAudioProcessor& processor, const juce::AudioBuffer<float>& input,
+                juce::AudioBuffer<float>& output, int renderBlockSize, double bpm = 120.0,
+                const std::function<void(int)>& afterBlock = {});
+
+    // Runs noise through the reverse engine one sample at a time and returns
+    // the average distance between its segment boundaries and their number.
+    std::pair<double, int> measureSegments(DelayAudioProcessor& processor, double seconds, double bpm);
+
+    static juce::String getGoldenName(const Benchmark::Preset& preset, Benchmark::Signal signal);
+    static float getMaxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b,
+                                  int offset = 0);
+
+    // Compares every signal through every preset with its reference.
+    void checkGolden();
+
+    // Renders every preset with each supported kernel path and compares it
+    // with the scalar path.
+    void checkKernelPaths();
+
+    // A burst followed by silence at 100% feedback, forwards and reversed,
+    // must stay finite, within 12 dB of the burst, and not build up over time.
+    void checkFeedbackBounded();
+
+    // Reverse segments are cut at the delay time, exactly on average for
+    // delay times that are no whole number of samples.
+    void checkReverseSegments();
+
+    // The synced echo and the synced reverse segment follow
+    // Tempo::getMillisecondsForNoteLength at a tempo other than the default.
+    void checkTempoSync();
+
+    // Every kernel path converts every finite half and a few million random
+    // floats to the same bits as the scalar path, with and without FTZ/DAZ.
+    void checkHalfFloats();
+
+    // The pipelined output is bit-identical to the serial one, one block
+    // later.
+    void checkPipeline();
+
+    // A batch render gives the same files with one worker as with several.
+    void checkBatchThreads();
+
+    // After a reset the spectral engine plays nothing it heard before, even
+    // with the blur reaching across frames.
+    void checkSpectralReset();
+
+    // With onsets triggering the reverse segments and lookahead on, every
+    // swell peaks on its own transient at the reported latency, including
+    // segments that an onset cut short.
+    void checkSwellAlignment();
+
+    // On a four-channel bus, the second lane echoes at its own multiple of
+    // the delay time, and its settings survive saving and loading.
+    void checkLaneSettings();
+
+    // A history that grows while noise runs through it, on the background
+    // thread or right away, still holds every sample it held before.
+    void checkHistoryGrowth();
+
+    // A session saved with the old delay time ID loads its delay time.
+    void checkLegacyState();
+
+    void expect(bool condition, const juce::String& name, const juce::String& detail = {});
+
+    juce::File goldenFolder;
+    bool updateGolden;
+
+    static constexpr double sampleRate = 44100.0;
+    static constexpr int blockSize = 512;
+    static constexpr double goldenSeconds = 2.0;
+
+    int numChecks = 0;
+    int numFailed = 0;
+};